@@ -0,0 +1,82 @@
+#include "arena.h"
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/mman.h>
+#include <sys/resource.h>
+#endif
+
+#define HUGE_PAGE_SIZE ((size_t)2 << 20)
+
+static int hugePagesMode = HUGEPAGES_NONE;
+
+void setHugePages(int mode)
+{
+	hugePagesMode = mode;
+}
+
+char *allocateArena(size_t bytes, int &mode)
+{
+#ifndef _WIN32
+	//Whole huge pages; the kernel gives such mappings huge-page alignment
+	size_t rounded = (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+	if (hugePagesMode == HUGEPAGES_EXPLICIT) {
+		void *p = mmap(NULL, rounded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if (p != MAP_FAILED) {
+			mode = HUGEPAGES_EXPLICIT;
+			return (char *)p;
+		}
+	}
+	if (hugePagesMode != HUGEPAGES_NONE) {
+		void *p = mmap(NULL, rounded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (p != MAP_FAILED) {
+			madvise(p, rounded, MADV_HUGEPAGE);
+			mode = HUGEPAGES_TRANSPARENT;
+			return (char *)p;
+		}
+	}
+#endif
+	mode = HUGEPAGES_NONE;
+	//Over-allocate so that the block can start on 64 bytes; the offset is kept just before it
+	char *raw = new char[bytes + 64];
+	char *block = raw + 64 - ((size_t)raw & 63);
+	block[-1] = (char)(block - raw);
+	return block;
+}
+
+void freeArena(char *block, size_t bytes, int mode)
+{
+	if (block == NULL) return;
+#ifndef _WIN32
+	if (mode != HUGEPAGES_NONE) {
+		munmap(block, (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE);
+		return;
+	}
+#endif
+	delete[] (block - (unsigned char)block[-1]);
+}
+
+const char *hugePagesName(int mode)
+{
+	if (mode == HUGEPAGES_EXPLICIT) return "explicit huge pages";
+	if (mode == HUGEPAGES_TRANSPARENT) return "transparent huge pages";
+	return "normal pages";
+}
+
+double peakResidentMB()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS pmc;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) return 0;
+	return pmc.PeakWorkingSetSize / 1048576.0;
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+	//ru_maxrss is in kilobytes on Linux
+	return usage.ru_maxrss / 1024.0;
+#endif
+}
@@ -0,0 +1,25 @@
+#ifndef ARENA_INCLUDED
+#define ARENA_INCLUDED
+
+#include <stddef.h>
+
+// How the memory of the search arenas (see manipulateArrays.cpp) is obtained
+#define HUGEPAGES_NONE 0         // ordinary heap memory
+#define HUGEPAGES_TRANSPARENT 1  // anonymous mapping marked with madvise(MADV_HUGEPAGE)
+#define HUGEPAGES_EXPLICIT 2     // MAP_HUGETLB mapping, or as HUGEPAGES_TRANSPARENT if none are reserved
+
+// Sets how the arenas allocated from now on are backed (DEFAULT = HUGEPAGES_NONE). Huge pages
+// are only available on Linux; elsewhere the arenas always come from the heap.
+void setHugePages(int mode);
+
+// A block of memory of at least bytes bytes, aligned on 64 bytes. mode receives the kind of
+// pages actually used, to be given back to freeArena().
+char *allocateArena(size_t bytes, int &mode);
+void freeArena(char *block, size_t bytes, int mode);
+
+const char *hugePagesName(int mode);
+
+// Peak resident memory of the process so far, in megabytes (0 if it cannot be read)
+double peakResidentMB();
+
+#endif
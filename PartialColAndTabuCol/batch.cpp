@@ -0,0 +1,256 @@
+#include "batch.h"
+#include "Graph.h"
+#include "inputGraph.h"
+#include "manipulateArrays.h"
+#include "kSearch.h"
+#include "clique.h"
+#include "solve.h"
+#include "workStealing.h"
+#include "arena.h"
+#include "../common/dimacsWriter.h"
+#include "rng.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <mutex>
+#include <filesystem>
+#include <limits.h>
+#include <stdlib.h>
+
+//This makes sure the compiler uses _strtoui64(x, y, z) with Microsoft Compilers, otherwise strtoull(x, y, z) is used
+#ifdef _MSC_VER
+  #define strtoull(x, y, z) _strtoui64(x, y, z)
+#endif
+
+using namespace std;
+
+struct BatchJob {
+	int line;
+	string name, graphFile, error;
+	int algorithm, tenure, randomSeed, targetCols, constructiveAlg, strategy, lowerBound, cliqueMode, runs;
+	bool reduce, components;
+	unsigned long long maxChecks;
+	double timeLimit, kTimeLimit;
+};
+
+// A graph read by the first job that needs it and freed after the last one
+struct CachedGraph {
+	Graph *g;
+	int **neighbors;
+	bool ok;
+	string error;
+	int pending;
+	once_flag loaded;
+};
+
+static bool parseJob(const string &text, int line, BatchJob &job)
+{
+	//The defaults of main()
+	job.line = line;
+	job.algorithm = 1;
+	job.tenure = 0;
+	job.randomSeed = 1;
+	job.targetCols = 1;
+	job.constructiveAlg = 1;
+	job.strategy = KSEARCH_LINEAR;
+	job.lowerBound = 1;
+	job.cliqueMode = CLIQUE_GREEDY;
+	job.runs = 5;
+	job.reduce = false;
+	job.components = false;
+	job.maxChecks = INT_MAX;
+	job.timeLimit = job.kTimeLimit = 0;
+
+	istringstream in(text);
+	vector<string> words;
+	string w;
+	while (in >> w) words.push_back(w);
+	for (size_t i = 0; i < words.size(); i++) {
+		bool hasValue = i + 1 < words.size();
+		const char *value = hasValue ? words[i + 1].c_str() : "";
+		if (words[i] == "-t") job.algorithm = 2;
+		else if (words[i] == "-tt") job.tenure++;
+		else if (words[i] == "-v") continue;
+		else if (words[i] == "--reduce") job.reduce = true;
+		else if (words[i] == "--components") job.components = true;
+		else if (words[i][0] == '-' && !hasValue) {
+			job.error = "missing value for " + words[i];
+			return false;
+		}
+		else if (words[i] == "-s") { job.maxChecks = strtoull(value, NULL, 10); i++; }
+		else if (words[i] == "-r") { job.randomSeed = atoi(value); i++; }
+		else if (words[i] == "-T") { job.targetCols = atoi(value); i++; }
+		else if (words[i] == "-a") { job.constructiveAlg = atoi(value); i++; }
+		else if (words[i] == "--k-search") { job.strategy = atoi(value); i++; }
+		else if (words[i] == "--lower-bound") { job.lowerBound = atoi(value); i++; }
+		else if (words[i] == "--clique") { job.cliqueMode = atoi(value); i++; }
+		else if (words[i] == "--time-limit") { job.timeLimit = atof(value); i++; }
+		else if (words[i] == "--k-time-limit") { job.kTimeLimit = atof(value); i++; }
+		else if (words[i] == "--runs") { job.runs = atoi(value); i++; }
+		else if (words[i] == "--name") { job.name = value; i++; }
+		else if (words[i][0] == '-') {
+			job.error = "option " + words[i] + " cannot be used in a batch";
+			return false;
+		}
+		else job.graphFile = words[i];
+	}
+	if (job.graphFile.empty()) {
+		job.error = "no graph file";
+		return false;
+	}
+	if (job.runs < 1) job.runs = 1;
+	if (job.name.empty()) job.name = "job" + to_string(line);
+	return true;
+}
+
+static void loadGraph(CachedGraph &cg, const string &file)
+{
+	//A missing or malformed graph only fails the jobs that use it
+	cg.g = new Graph;
+	cg.ok = readDimacsGraph(*cg.g, file.c_str(), cg.error);
+	if (!cg.ok) {
+		delete cg.g;
+		cg.g = NULL;
+		return;
+	}
+	cg.neighbors = new int*[cg.g->n];
+	makeAdjList(cg.neighbors, *cg.g);
+}
+
+static void writeResultLine(ostream &log, BatchJob &job, int targetCols, int k, int fail, int lowerBound)
+{
+	//The line main() adds to resultsLog.log, with the target as clamped by main()
+	log << (job.algorithm == 1 ? "partialcol " : "tabucol ") << "targetK " << targetCols << (job.tenure ? " dynamic " : " reactive ") << k
+		<< (fail < job.runs ? " HIT " : " MISS ") << job.runs - fail << " LB " << lowerBound << endl;
+}
+
+int runBatch(const char *manifestFile, const char *outDir, int numWorkers, int verbose)
+{
+	ifstream manifest(manifestFile);
+	if (manifest.fail()) { cout << "ERROR OPENING manifest FILE " << manifestFile << endl; exit(1); }
+	error_code ec;
+	filesystem::create_directories(outDir, ec);
+	if (ec) { cout << "ERROR: cannot create the output directory " << outDir << endl; exit(1); }
+
+	//Read the jobs; a graph used by several of them is only read once
+	vector<BatchJob> jobs;
+	map<string, CachedGraph *> graphs;
+	set<string> names;
+	int errors = 0;
+	string text;
+	for (int line = 1; getline(manifest, text); line++) {
+		size_t start = text.find_first_not_of(" \t\r");
+		if (start == string::npos || text[start] == '#') continue;
+		BatchJob job;
+		if (parseJob(text, line, job) && !names.insert(job.name).second) job.error = "the name " + job.name + " is used twice";
+		if (!job.error.empty()) {
+			cout << manifestFile << " line " << line << ": " << job.error << endl;
+			errors++;
+			continue;
+		}
+		CachedGraph *&cg = graphs[job.graphFile];
+		if (cg == NULL) {
+			cg = new CachedGraph;
+			cg->g = NULL;
+			cg->neighbors = NULL;
+			cg->pending = 0;
+		}
+		cg->pending++;
+		jobs.push_back(job);
+	}
+
+	//Each worker keeps its colouring buffers from one job to the next, and the search arrays are
+	//kept by the thread (see initializeArrays())
+	vector< vector<int> > colourings(numWorkers), bestColourings(numWorkers);
+	mutex lock;
+	int finished = 0, hits = 0;
+	double start = readClock(CLOCK_WALL);
+
+	WorkStealingPool pool(numWorkers);
+	pool.run((int)jobs.size(), [&](int j, int worker) {
+		BatchJob &job = jobs[j];
+		CachedGraph &cg = *graphs[job.graphFile];
+		call_once(cg.loaded, loadGraph, ref(cg), cref(job.graphFile));
+		string base = string(outDir) + "/" + job.name;
+		ofstream log((base + ".log").c_str());
+		bool hit = false;
+
+		if (!cg.ok) log << "ERROR READING graph FILE " << job.graphFile << ": " << cg.error;
+		else {
+			Graph &g = *cg.g;
+			KSearchParams p;
+			p.strategy = job.strategy;
+			p.algorithm = job.algorithm;
+			p.tenure = job.tenure;
+			p.verbose = 0;
+			p.frequency = 0;
+			p.increment = 0;
+			p.targetCols = job.targetCols < 2 || job.targetCols > g.n ? 2 : job.targetCols;
+			//The workers are busy with the other jobs, so the clique is grown on this thread only
+			bool proven;
+			p.lowerBound = max(job.lowerBound, cliqueBound(g, cg.neighbors, job.cliqueMode, 1, proven));
+			p.maxChecks = job.maxChecks;
+			p.clockType = CLOCK_WALL;
+			p.timeLimit = job.timeLimit;
+			p.kTimeLimit = job.kTimeLimit;
+			p.pool = NULL;
+			p.checkpoint = NULL;
+			p.trace = NULL;
+			p.solution = NULL;
+			p.reduce = job.reduce;
+			//The workers are taken by the jobs, so the components of a job are searched one after the other
+			p.components = job.components;
+			p.componentPool = NULL;
+
+			//The runs of main() for this seed, keeping the best colouring of all of them
+			vector<int> &colouring = colourings[worker], &best = bestColourings[worker];
+			colouring.resize(g.n);
+			best.resize(g.n);
+			ostream confStream(NULL), timeStream(NULL);
+			int fail = 0, k = 0, bestK = INT_MAX;
+			rngState = 1;
+			for (int run = 0; run < job.runs; run++) {
+				RunResult r = solveRun(g, cg.neighbors, job.constructiveAlg, job.randomSeed, p, &colouring[0], confStream, timeStream);
+				fail += r.fails;
+				k = r.searchK;
+				if (r.bestK < bestK) {
+					bestK = r.bestK;
+					best.swap(colouring);
+				}
+			}
+			hit = fail < job.runs;
+
+			DimacsWriter solStrm;
+			solStrm.open((base + ".solution.txt").c_str());
+			solStrm.putInt(g.n);
+			solStrm.put('\n');
+			for (int i = 0; i < g.n; i++) solStrm.colour(i + 1, best[i]);
+			if (!solStrm.close()) cout << "WARNING: could not write solution file " << base << ".solution.txt" << endl;
+			writeResultLine(log, job, p.targetCols, k, fail, p.lowerBound);
+		}
+		log.close();
+
+		lock_guard<mutex> guard(lock);
+		if (--cg.pending == 0 && cg.g != NULL) {
+			for (int i = 0; i < cg.g->n; i++) delete[] cg.neighbors[i];
+			delete[] cg.neighbors;
+			delete cg.g;
+			cg.neighbors = NULL;
+			cg.g = NULL;
+		}
+		if (!cg.ok) errors++;
+		if (hit) hits++;
+		finished++;
+		if (verbose >= 1) cout << "[" << finished << "/" << jobs.size() << "] " << job.name << " (" << job.graphFile << ")"
+			<< (cg.ok ? (hit ? " HIT" : " MISS") : " ERROR") << endl;
+	});
+
+	cout << jobs.size() << " jobs in " << readClock(CLOCK_WALL) - start << "s on " << numWorkers << " workers: " << hits << " HIT, "
+		<< (int)jobs.size() - hits << " MISS or ERROR. Results in " << outDir << ". Peak resident memory " << peakResidentMB() << " MB" << endl;
+	for (map<string, CachedGraph *>::iterator it = graphs.begin(); it != graphs.end(); it++) delete it->second;
+	return errors;
+}
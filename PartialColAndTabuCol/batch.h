@@ -0,0 +1,13 @@
+#ifndef BATCH_INCLUDED
+#define BATCH_INCLUDED
+
+// --batch <manifest>: solves every job of the manifest in this process, on numWorkers threads.
+// Each line of the manifest is a graph file followed by the options of that job, as they would be
+// given to PartialColAndTabuCol (-t -tt -s -r -T -a --k-search --lower-bound --clique --time-limit
+// --k-time-limit --reduce --components), plus "--runs <int>" (number of seeds, DEFAULT = 5) and "--name <name>".
+// Empty lines and lines starting with '#' are skipped. The best colouring and the results log line
+// of a job go to <outDir>/<name>.solution.txt and <outDir>/<name>.log, the name being job<line> by
+// default. Returns the number of jobs that could not be run.
+int runBatch(const char *manifestFile, const char *outDir, int numWorkers, int verbose);
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef CHECKCOUNTER_INCLUDED
+#define CHECKCOUNTER_INCLUDED
+
+#include "threadLocal.h"
+
+extern THREAD_LOCAL unsigned long long numConfChecks;
+
+// Policies for counting constraint checks in the search loops. CountChecks counts every check
+// where it is made, as in the original code. EstimateChecks compiles those increments out and
+// instead adds one estimate per iteration (or per move), which keeps numConfChecks usable as a
+// stopping criterion without touching memory in the inner loops.
+struct CountChecks {
+	static inline void add(unsigned long long n) { numConfChecks += n; }
+	static inline void estimate(unsigned long long) { }
+};
+
+struct EstimateChecks {
+	static inline void add(unsigned long long) { }
+	static inline void estimate(unsigned long long n) { numConfChecks += n; }
+};
+
+// The research build counts every check; "make throughput" defines THROUGHPUT_BUILD
+#ifdef THROUGHPUT_BUILD
+typedef EstimateChecks CheckCounter;
+#else
+typedef CountChecks CheckCounter;
+#endif
+
+#endif
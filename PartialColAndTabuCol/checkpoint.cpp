@@ -0,0 +1,263 @@
+#include "checkpoint.h"
+#include "parallelScan.h"
+#include "rng.h"
+#include "solutionWriter.h"
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+
+using namespace std;
+
+extern THREAD_LOCAL unsigned long long numConfChecks;
+
+#define CHECKPOINT_MAGIC "PCTCKPT"
+#define CHECKPOINT_VERSION 2
+
+static void put(vector<char> &buf, const void *data, size_t bytes)
+{
+	const char *p = (const char *)data;
+	buf.insert(buf.end(), p, p + bytes);
+}
+
+static bool get(const vector<char> &buf, size_t &pos, void *data, size_t bytes)
+{
+	if (pos + bytes > buf.size()) return false;
+	memcpy(data, &buf[pos], bytes);
+	pos += bytes;
+	return true;
+}
+
+static void corrupt()
+{
+	cout << "ERROR: the checkpoint file is truncated or does not match this search" << endl;
+	exit(1);
+}
+
+Checkpointer::Checkpointer(const string &file, double seconds)
+{
+	fileName = file;
+	interval = seconds;
+	nextAt = readClock(CLOCK_WALL) + interval;
+	searchPos = 0;
+	resuming = false;
+	bestColouringNow = NULL;
+	clockStart = 0;
+	wallStart = 0;
+	confStream = timeStream = NULL;
+	pool = NULL;
+	solution = NULL;
+	memset(&run, 0, sizeof(run));
+	hasPending = writing = stop = false;
+	writer = thread(&Checkpointer::writerLoop, this);
+}
+
+Checkpointer::~Checkpointer()
+{
+	{
+		unique_lock<mutex> guard(lock);
+		stop = true;
+	}
+	cond.notify_all();
+	writer.join();
+}
+
+void Checkpointer::writerLoop()
+{
+	unique_lock<mutex> guard(lock);
+	while (true) {
+		cond.wait(guard, [&] { return stop || hasPending; });
+		if (hasPending) {
+			vector<char> data;
+			data.swap(pending);
+			hasPending = false;
+			writing = true;
+			guard.unlock();
+
+			//Write a new file and rename it, so that an interruption never leaves a partial checkpoint
+			string tmpName = fileName + ".tmp";
+			ofstream out(tmpName.c_str(), ios::binary | ios::trunc);
+			out.write(&data[0], data.size());
+			out.close();
+			if (out.fail()) cout << "WARNING: could not write checkpoint file " << tmpName << endl;
+			else {
+#ifdef _WIN32
+				remove(fileName.c_str());
+#endif
+				rename(tmpName.c_str(), fileName.c_str());
+			}
+
+			guard.lock();
+			writing = false;
+			cond.notify_all();
+		}
+		else if (stop) return;
+	}
+}
+
+bool Checkpointer::due()
+{
+	if (interval <= 0) return false;
+	double now = readClock(CLOCK_WALL);
+	if (now < nextAt) return false;
+	nextAt = now + interval;
+	return true;
+}
+
+void Checkpointer::startAttempt(int k, unsigned long long limit, const Deadline &deadline)
+{
+	double start = deadline.clockType == CLOCK_CPU ? (double)clockStart / CLOCKS_PER_SEC : wallStart;
+	run.probeK = k;
+	run.probeLimit = limit;
+	run.probeDeadline = deadline.at > 0 ? deadline.at - start : 0;
+}
+
+Deadline Checkpointer::resumeDeadline(int clockType)
+{
+	Deadline d;
+	d.clockType = clockType;
+	d.at = 0;
+	if (run.probeDeadline > 0) d.at = (clockType == CLOCK_CPU ? (double)clockStart / CLOCKS_PER_SEC : wallStart) + run.probeDeadline;
+	return d;
+}
+
+void Checkpointer::saveSearch(const SearchState &s, Graph &g, int *c, int **nodesByColor, int *nodesInConflict, int **tabuStatus)
+{
+	RunState r = run;
+	r.checks = numConfChecks;
+	r.random = rngState;
+	r.cpuElapsed = (double)(clock() - clockStart) / CLOCKS_PER_SEC;
+	r.wallElapsed = readClock(CLOCK_WALL) - wallStart;
+	confStream->flush();
+	timeStream->flush();
+	r.confPos = (long long)confStream->tellp();
+	r.timePos = (long long)timeStream->tellp();
+	//The best colouring of the earlier seeds, so that solution.txt is not replaced by a worse one on resume
+	vector<int> best;
+	r.bestK = solution != NULL ? solution->bestColouring(best) : INT_MAX;
+	if ((int)best.size() != g.n) r.bestK = INT_MAX;
+
+	vector<char> buf;
+	int version = CHECKPOINT_VERSION, runBytes = sizeof(RunState);
+	put(buf, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+	put(buf, &version, sizeof(int));
+	put(buf, &runBytes, sizeof(int));
+	put(buf, &r, sizeof(RunState));
+	put(buf, bestColouringNow, g.n * sizeof(int));
+	if (r.bestK != INT_MAX) put(buf, &best[0], g.n * sizeof(int));
+	int numSlices = pool != NULL ? (int)pool->sliceRandomState().size() : 0;
+	put(buf, &numSlices, sizeof(int));
+	if (numSlices > 0) put(buf, &pool->sliceRandomState()[0], numSlices * sizeof(unsigned long long));
+
+	//The search itself: scalars, colouring, the order of every list (tie-breaking depends on it) and the tabu table
+	put(buf, &s, sizeof(SearchState));
+	put(buf, c, g.n * sizeof(int));
+	for (int col = 0; col <= s.k; col++) put(buf, nodesByColor[col], (nodesByColor[col][0] + 1) * sizeof(int));
+	int listSize = nodesInConflict != NULL ? nodesInConflict[0] : -1;
+	put(buf, &listSize, sizeof(int));
+	if (listSize > 0) put(buf, nodesInConflict + 1, listSize * sizeof(int));
+	for (int i = 0; i < g.n; i++) put(buf, tabuStatus[i], (s.k + 1) * sizeof(int));
+
+	{
+		unique_lock<mutex> guard(lock);
+		pending.swap(buf);
+		hasPending = true;
+	}
+	cond.notify_all();
+}
+
+bool Checkpointer::load(string &error)
+{
+	ifstream in(fileName.c_str(), ios::binary);
+	if (in.fail()) {
+		error = "cannot open " + fileName;
+		return false;
+	}
+	vector<char> buf((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+	size_t pos = 0;
+
+	char magic[sizeof(CHECKPOINT_MAGIC)];
+	int version, runBytes;
+	RunState r;
+	if (!get(buf, pos, magic, sizeof(magic)) || memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)) != 0
+		|| !get(buf, pos, &version, sizeof(int)) || version != CHECKPOINT_VERSION
+		|| !get(buf, pos, &runBytes, sizeof(int)) || runBytes != (int)sizeof(RunState)
+		|| !get(buf, pos, &r, sizeof(RunState))) {
+		error = fileName + " is not a checkpoint written by this version";
+		return false;
+	}
+	if (r.n != run.n || r.nbEdges != run.nbEdges) {
+		error = "the checkpoint was made for a different graph";
+		return false;
+	}
+	if (r.algorithm != run.algorithm || r.tenure != run.tenure || r.strategy != run.strategy || r.randomSeed != run.randomSeed) {
+		error = "the checkpoint was made with different -t, -tt, --k-search or -r options";
+		return false;
+	}
+
+	bestColouring.resize(r.n);
+	solutionColouring.resize(r.bestK != INT_MAX ? r.n : 0);
+	int numSlices;
+	if (!get(buf, pos, &bestColouring[0], r.n * sizeof(int))
+		|| (r.bestK != INT_MAX && !get(buf, pos, &solutionColouring[0], r.n * sizeof(int)))
+		|| !get(buf, pos, &numSlices, sizeof(int)) || numSlices < 0) {
+		error = fileName + " is truncated";
+		return false;
+	}
+	sliceRandom.resize(numSlices);
+	if (numSlices > 0 && !get(buf, pos, &sliceRandom[0], numSlices * sizeof(unsigned long long))) {
+		error = fileName + " is truncated";
+		return false;
+	}
+
+	run = r;
+	search.assign(buf.begin() + pos, buf.end());
+	searchPos = 0;
+	resuming = true;
+	return true;
+}
+
+void Checkpointer::resumeColouring(Graph &g, int *c, int algorithm, int k)
+{
+	SearchState s;
+	searchPos = 0;
+	if (!get(search, searchPos, &s, sizeof(SearchState)) || s.algorithm != algorithm || s.k != k) corrupt();
+	if (!get(search, searchPos, c, g.n * sizeof(int))) corrupt();
+}
+
+void Checkpointer::resumeSearch(SearchState &s, Graph &g, int **nodesByColor, int *nbcPosition, int *nodesInConflict, int *confPosition, int **tabuStatus)
+{
+	size_t pos = 0;
+	get(search, pos, &s, sizeof(SearchState));
+
+	//Put the lists back in the order they had, which initializeArrays() does not reproduce
+	for (int col = 0; col <= s.k; col++) {
+		if (!get(search, searchPos, nodesByColor[col], sizeof(int)) || nodesByColor[col][0] < 0 || nodesByColor[col][0] > g.n) corrupt();
+		if (!get(search, searchPos, nodesByColor[col] + 1, nodesByColor[col][0] * sizeof(int))) corrupt();
+		for (int i = 1; i <= nodesByColor[col][0]; i++) nbcPosition[nodesByColor[col][i]] = i;
+	}
+	int listSize;
+	if (!get(search, searchPos, &listSize, sizeof(int)) || listSize > g.n || (listSize >= 0) != (nodesInConflict != NULL)) corrupt();
+	if (listSize >= 0) {
+		nodesInConflict[0] = listSize;
+		if (!get(search, searchPos, nodesInConflict + 1, listSize * sizeof(int))) corrupt();
+		for (int i = 1; i <= listSize; i++) confPosition[nodesInConflict[i]] = i;
+	}
+	for (int i = 0; i < g.n; i++) {
+		if (!get(search, searchPos, tabuStatus[i], (s.k + 1) * sizeof(int))) corrupt();
+	}
+
+	//Building the arrays again has counted checks that the original run did not make
+	numConfChecks = run.checks;
+	search.clear();
+	resuming = false;
+}
+
+void Checkpointer::finish()
+{
+	{
+		unique_lock<mutex> guard(lock);
+		cond.wait(guard, [&] { return !hasPending && !writing; });
+	}
+	remove(fileName.c_str());
+}
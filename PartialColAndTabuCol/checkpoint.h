@@ -0,0 +1,113 @@
+#ifndef CHECKPOINT_INCLUDED
+#define CHECKPOINT_INCLUDED
+
+#include "Graph.h"
+#include "timeLimit.h"
+#include <fstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <time.h>
+
+class ParallelScan;
+class SolutionWriter;
+
+// Where a run stands outside tabu()/reactcol(). The first block identifies the run and is compared
+// on --resume; the rest is kept up to date by main() and kSearch() and copied into each checkpoint.
+struct RunState {
+	int n, nbEdges, algorithm, tenure, strategy, randomSeed;
+
+	int run;                         // index of the seed in the loop of main()
+	int fail, miss;                  // as in main() when the run started
+	int startK;                      // k given by the constructive algorithm
+	int lo, hi, step, galloping;     // position of a bisection or galloping k-search
+	int probeK;                      // value of k being attempted
+	unsigned long long probeLimit;   // checks limit of that attempt
+	double probeDeadline;            // its deadline, relative to the start of the run (0 = none)
+
+	unsigned long long checks;       // numConfChecks
+	unsigned long long random;       // rngState
+	double cpuElapsed, wallElapsed;  // time used by the run so far
+	long long confPos, timePos;      // lengths of ceffort.txt and teffort.txt
+
+	int bestK;                       // colours of the best colouring of all seeds so far (INT_MAX = none)
+};
+
+// The scalar part of the state of tabu() and reactcol()
+struct SearchState {
+	int algorithm, k;
+	long totalIterations;
+	int currentIterations, totalConflicts, bestSolutionValue, minSolutionValue, maxSolutionValue;
+	int tabuTenure, randomTenure, pairCycles, frequency, increment, nextPair, nextVerbose;
+};
+
+// Periodic binary checkpoints of a run, so that --resume can continue it exactly where it was.
+// The search loops poll due() together with the clock; save() copies the state into a buffer on
+// the calling thread and a writer thread puts it on disk (written to <file>.tmp, then renamed),
+// so the search only stalls for the copy. If a write is still going on, the newer checkpoint
+// replaces the one waiting to be written.
+class Checkpointer {
+public:
+
+	Checkpointer(const std::string &fileName, double interval);
+	~Checkpointer();
+
+	// Reads the checkpoint file into run, bestColouring, solutionColouring, sliceRandom and the
+	// pending search state.
+	// Returns false, with a message in error, if it is missing or belongs to another run.
+	bool load(std::string &error);
+
+	// True at most once every interval seconds of wall-clock time (never if interval <= 0)
+	bool due();
+
+	// Queues a checkpoint of the run with the given search state
+	void saveSearch(const SearchState &s, Graph &g, int *c, int **nodesByColor, int *nodesInConflict, int **tabuStatus);
+
+	// Used by tabu()/reactcol() when resuming: first the colouring (before the arrays are built),
+	// then the rest of the state, after which numConfChecks is that of the checkpoint
+	void resumeColouring(Graph &g, int *c, int algorithm, int k);
+	void resumeSearch(SearchState &s, Graph &g, int **nodesByColor, int *nbcPosition, int *nodesInConflict, int *confPosition, int **tabuStatus);
+
+	// The checks limit and deadline of the attempt being resumed
+	Deadline resumeDeadline(int clockType);
+	// Records the attempt that is about to start
+	void startAttempt(int k, unsigned long long limit, const Deadline &deadline);
+
+	// Waits for the last write and deletes the file, once all runs have finished
+	void finish();
+
+	RunState run;
+	std::vector<int> bestColouring;        // filled by load()
+	std::vector<int> solutionColouring;    // best colouring of all seeds (run.bestK colours), filled by load()
+	std::vector<unsigned long long> sliceRandom;
+
+	// Set by main() for the current run
+	int *bestColouringNow;
+	clock_t clockStart;
+	double wallStart;
+	std::ofstream *confStream, *timeStream;
+	ParallelScan *pool;
+	SolutionWriter *solution;              // holds the best colouring of all seeds, NULL = none
+
+	// True from load() until the search state has been handed back to tabu()/reactcol()
+	bool resuming;
+
+private:
+
+	void writerLoop();
+
+	std::string fileName;
+	double interval, nextAt;
+	std::vector<char> search;
+	size_t searchPos;
+
+	std::thread writer;
+	std::mutex lock;
+	std::condition_variable cond;
+	std::vector<char> pending;
+	bool hasPending, writing, stop;
+};
+
+#endif
@@ -0,0 +1,117 @@
+#include "clique.h"
+#include <vector>
+#include <thread>
+#include <algorithm>
+
+using namespace std;
+
+// The largest of the cliques grown from the vertices start, start + step, start + 2 step, ...
+// Each clique takes the vertices in order of decreasing degree, adding those adjacent to all of it.
+static void greedyCliques(Graph &g, const vector<int> &order, int start, int step, vector<int> &best)
+{
+	vector<int> clique;
+	for (int s = start; s < g.n; s += step) {
+		int v = order[s];
+		int *vRow = g[v];
+		clique.assign(1, v);
+		for (int i = 0; i < g.n; i++) {
+			int u = order[i];
+			if (!vRow[u]) continue;
+			int *uRow = g[u];
+			size_t j = 1;
+			while (j < clique.size() && uRow[clique[j]]) j++;
+			if (j == clique.size()) clique.push_back(u);
+		}
+		if (clique.size() > best.size()) best = clique;
+	}
+}
+
+// Branch and bound in the style of Tomita's MCQ: the candidates are greedily coloured, and a branch
+// is cut when the clique so far plus the number of colours left cannot beat the best clique
+struct CliqueSearch {
+	Graph &g;
+	vector<int> best, current;
+	long long nodes;
+	bool aborted;
+
+	CliqueSearch(Graph &g) : g(g), nodes(0), aborted(false) {}
+
+	//Orders the candidates by colour class; colour[i] is the number of classes up to order[i]
+	void colourSort(const vector<int> &candidates, vector<int> &order, vector<int> &colour)
+	{
+		vector< vector<int> > classes;
+		for (size_t i = 0; i < candidates.size(); i++) {
+			int v = candidates[i];
+			int *vRow = g[v];
+			size_t c;
+			for (c = 0; c < classes.size(); c++) {
+				size_t j = 0;
+				while (j < classes[c].size() && !vRow[classes[c][j]]) j++;
+				if (j == classes[c].size()) break;
+			}
+			if (c == classes.size()) classes.push_back(vector<int>());
+			classes[c].push_back(v);
+		}
+		order.clear();
+		colour.clear();
+		for (size_t c = 0; c < classes.size(); c++) {
+			for (size_t j = 0; j < classes[c].size(); j++) {
+				order.push_back(classes[c][j]);
+				colour.push_back((int)c + 1);
+			}
+		}
+	}
+
+	void expand(const vector<int> &candidates)
+	{
+		if (++nodes > CLIQUE_NODE_LIMIT) {
+			aborted = true;
+			return;
+		}
+		vector<int> order, colour, next;
+		colourSort(candidates, order, colour);
+		for (int i = (int)order.size() - 1; i >= 0 && !aborted; i--) {
+			if (current.size() + colour[i] <= best.size()) return;
+			int v = order[i];
+			int *vRow = g[v];
+			current.push_back(v);
+			next.clear();
+			for (int j = 0; j < i; j++) if (vRow[order[j]]) next.push_back(order[j]);
+			if (next.empty()) {
+				if (current.size() > best.size()) best = current;
+			}
+			else expand(next);
+			current.pop_back();
+		}
+	}
+};
+
+int cliqueBound(Graph &g, int **neighbors, int mode, int numThreads, bool &proven)
+{
+	proven = false;
+	if (mode == CLIQUE_NONE || g.n == 0) return g.n == 0 ? 0 : 1;
+
+	//Vertices by decreasing degree
+	vector<int> order(g.n);
+	for (int i = 0; i < g.n; i++) order[i] = i;
+	sort(order.begin(), order.end(), [&](int a, int b) { return neighbors[a][0] > neighbors[b][0] || (neighbors[a][0] == neighbors[b][0] && a < b); });
+
+	if (numThreads < 1) numThreads = 1;
+	if (numThreads > g.n) numThreads = g.n;
+	vector< vector<int> > found(numThreads);
+	vector<thread> threads;
+	for (int t = 1; t < numThreads; t++) threads.push_back(thread(greedyCliques, ref(g), cref(order), t, numThreads, ref(found[t])));
+	greedyCliques(g, order, 0, numThreads, found[0]);
+	for (size_t t = 0; t < threads.size(); t++) threads[t].join();
+	vector<int> best;
+	for (int t = 0; t < numThreads; t++) if (found[t].size() > best.size()) best = found[t];
+
+	if (mode == CLIQUE_EXACT) {
+		CliqueSearch search(g);
+		search.best = best;
+		search.expand(order);
+		best = search.best;
+		proven = !search.aborted;
+	}
+	return (int)best.size();
+}
@@ -0,0 +1,17 @@
+#ifndef CLIQUE_INCLUDED
+#define CLIQUE_INCLUDED
+
+#include "Graph.h"
+
+// How the clique lower bound on the number of colours is found
+#define CLIQUE_NONE 0    // no bound
+#define CLIQUE_GREEDY 1  // a greedy clique grown from every vertex, the vertices being shared out between threads
+#define CLIQUE_EXACT 2   // branch and bound from the greedy clique, stopped after CLIQUE_NODE_LIMIT nodes
+
+#define CLIQUE_NODE_LIMIT 100000
+
+// Returns the size of the largest clique found (1 for a graph without edges, 0 for an empty one).
+// proven is set when the clique is known to be maximum, i.e. when the exact search finished.
+int cliqueBound(Graph &g, int **neighbors, int mode, int numThreads, bool &proven);
+
+#endif
@@ -0,0 +1,104 @@
+#include "components.h"
+#include "threadLocal.h"
+
+using namespace std;
+
+extern THREAD_LOCAL unsigned long long numConfChecks;
+
+Components::Components(Graph &g, int **neighbors)
+{
+	//Label the components by breadth-first search, 2-colouring each one as it goes
+	int n = g.n;
+	vector<int> component(n, -1), queue(n), size;
+	vector<char> side(n, 0), bipartite;
+	for (int s = 0; s < n; s++) {
+		if (component[s] >= 0) continue;
+		int c = (int)size.size();
+		size.push_back(0);
+		bipartite.push_back(1);
+		component[s] = c;
+		int head = 0, tail = 0;
+		queue[tail++] = s;
+		while (head < tail) {
+			int v = queue[head++];
+			size[c]++;
+			numConfChecks += neighbors[v][0];
+			for (int j = 1; j <= neighbors[v][0]; j++) {
+				int u = neighbors[v][j];
+				if (component[u] < 0) {
+					component[u] = c;
+					side[u] = !side[v];
+					queue[tail++] = u;
+				}
+				else if (side[u] == side[v]) bipartite[c] = 0;
+			}
+		}
+	}
+	if (size.size() <= 1) return;
+
+	//Copy each component, with its adjacency lists cut out of one block
+	vector<int> index(n);
+	for (size_t c = 0; c < size.size(); c++) {
+		Part *part = new Part;
+		part->graph.resize(size[c]);
+		part->original.reserve(size[c]);
+		part->neighbors = new int*[size[c]];
+		parts.push_back(part);
+	}
+	vector<size_t> blockSize(size.size(), 0);
+	for (int v = 0; v < n; v++) {
+		Part *part = parts[component[v]];
+		index[v] = (int)part->original.size();
+		part->original.push_back(v);
+		if (bipartite[component[v]]) part->side.push_back(side[v]);
+		blockSize[component[v]] += neighbors[v][0] + 1;
+	}
+	for (size_t c = 0; c < parts.size(); c++) {
+		Part *part = parts[c];
+		int *row = new int[blockSize[c]];
+		blocks.push_back(row);
+		part->graph.nbEdges = 0;
+		for (int i = 0; i < part->graph.n; i++) {
+			int v = part->original[i];
+			part->neighbors[i] = row;
+			row[0] = neighbors[v][0];
+			for (int j = 1; j <= row[0]; j++) {
+				int u = index[neighbors[v][j]];
+				row[j] = u;
+				part->graph[i][u] = 1;
+			}
+			part->graph.nbEdges += row[0];
+			row += row[0] + 1;
+		}
+		part->graph.nbEdges /= 2;
+	}
+}
+
+Components::~Components()
+{
+	for (size_t c = 0; c < parts.size(); c++) {
+		delete[] parts[c]->neighbors;
+		delete parts[c];
+	}
+	for (size_t b = 0; b < blocks.size(); b++) delete[] blocks[b];
+}
+
+bool Components::colourDirectly(int c, int k, int *coloring)
+{
+	Part &part = *parts[c];
+	if (part.graph.n <= k) {
+		for (int i = 0; i < part.graph.n; i++) coloring[part.original[i]] = i + 1;
+		return true;
+	}
+	if (k >= 2 && !part.side.empty()) {
+		for (int i = 0; i < part.graph.n; i++) coloring[part.original[i]] = part.side[i] + 1;
+		return true;
+	}
+	return false;
+}
+
+void Components::merge(int c, const int *partColoring, int *coloring)
+{
+	Part &part = *parts[c];
+	for (int i = 0; i < part.graph.n; i++) coloring[part.original[i]] = partColoring[i];
+}
@@ -0,0 +1,38 @@
+#ifndef COMPONENTS_INCLUDED
+#define COMPONENTS_INCLUDED
+
+#include "Graph.h"
+#include <vector>
+
+// The connected components of a graph, each copied into a graph of its own so that they can be
+// searched separately at the same k. No edge joins two components, so their colourings can be put
+// together as they are, and the graph needs as many colours as its hardest component.
+class Components {
+public:
+
+	// parts is left empty when g is connected
+	Components(Graph &g, int **neighbors);
+	~Components();
+
+	struct Part {
+		Graph graph;                // the component, with its vertices numbered from 0
+		int **neighbors;            // its adjacency lists
+		std::vector<int> original;  // vertex of g for each vertex of the component
+		std::vector<char> side;     // a 2-colouring of the component (0/1), empty if it has an odd cycle
+	};
+
+	// Colours part c straight into coloring (colours 1..k, entries of g) when it has at most k
+	// vertices or is bipartite, and returns false without touching coloring otherwise
+	bool colourDirectly(int c, int k, int *coloring);
+
+	// Copies the colouring of part c (one entry per vertex of the part) into coloring (entries of g)
+	void merge(int c, const int *partColoring, int *coloring);
+
+	std::vector<Part *> parts;
+
+private:
+
+	std::vector<int *> blocks;
+};
+
+#endif
@@ -0,0 +1,580 @@
+#include "daemon.h"
+#include <iostream>
+
+#ifdef _WIN32
+
+using namespace std;
+
+int runDaemon(const char *socketPath, int numWorkers, int cacheSize, int verbose)
+{
+	cout << "ERROR: --daemon needs Unix-domain sockets, which this build does not support" << endl;
+	return 1;
+}
+
+#else
+
+#include "Graph.h"
+#include "inputGraph.h"
+#include "manipulateArrays.h"
+#include "kSearch.h"
+#include "solve.h"
+#include "clique.h"
+#include "rng.h"
+#include <sstream>
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+#include <set>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <limits.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+using namespace std;
+
+// Longest request line accepted (a precolouring of every vertex of a large graph fits)
+#define MAX_REQUEST (64 << 20)
+
+// A graph as it is kept between requests: read once and with its adjacency lists made, and its
+// clique bound for each --clique mode found by the first request that asks for it
+struct LoadedGraph {
+	Graph g;
+	int **neighbors;
+	unsigned long long hash;
+	unsigned long requests;
+	int clique[CLIQUE_EXACT + 1];            // 0 = not found yet
+	mutex cliqueLock;
+
+	LoadedGraph() : neighbors(NULL), hash(0), requests(0) {
+		for (int m = 0; m <= CLIQUE_EXACT; m++) clique[m] = 0;
+	}
+	~LoadedGraph() {
+		if (neighbors == NULL) return;
+		for (int i = 0; i < g.n; i++) delete[] neighbors[i];
+		delete[] neighbors;
+	}
+};
+
+// What is known of a graph file: its hash is only computed again when the file changes
+struct FileStamp {
+	long long size, mtime;
+	unsigned long long hash;
+};
+
+struct DaemonState {
+	int listenFd;
+	int numWorkers, cacheSize, verbose;
+
+	mutex lock;
+	condition_variable cond;
+	list< shared_ptr<LoadedGraph> > graphs;  // most recently used first
+	map<string, FileStamp> files;
+	set<int> connections;
+	int running;                             // requests being solved
+	unsigned long solves;
+	bool stop;
+};
+
+struct SolveRequest {
+	string graphFile, precolour;
+	bool byHash;
+	unsigned long long hash;
+	int algorithm, tenure, randomSeed, targetCols, constructiveAlg, strategy, lowerBound, cliqueMode, fixedK;
+	bool reduce, components;
+	unsigned long long maxChecks;
+	double timeLimit, kTimeLimit;
+};
+
+static bool sendAll(int fd, const string &text)
+{
+	size_t done = 0;
+	while (done < text.size()) {
+		ssize_t r = send(fd, text.data() + done, text.size() - done, MSG_NOSIGNAL);
+		if (r < 0 && errno == EINTR) continue;
+		if (r <= 0) return false;
+		done += r;
+	}
+	return true;
+}
+
+static string hexHash(unsigned long long h)
+{
+	char buf[17];
+	snprintf(buf, sizeof(buf), "%016llx", h);
+	return buf;
+}
+
+// Turns the lines that the search writes to ceffort.txt into PROGRESS lines sent to the client
+class ProgressBuf : public streambuf {
+public:
+	ProgressBuf(int fd, double start) : fd(fd), start(start) {}
+
+protected:
+	int overflow(int ch) {
+		if (ch == EOF) return 0;
+		if (ch != '\n') {
+			line += (char)ch;
+			return ch;
+		}
+		//"k checks", "k X checks" for a k that was not coloured, and "1 X" once the target is met
+		istringstream in(line);
+		vector<string> words;
+		string w;
+		while (in >> w) words.push_back(w);
+		line.clear();
+		if (words.size() < 2 || (words.size() == 2 && words[1] == "X")) return ch;
+		ostringstream out;
+		out << "PROGRESS k=" << words[0] << " checks=" << words.back() << " seconds=" << readClock(CLOCK_WALL) - start
+			<< (words[1] == "X" ? " failed" : "") << "\n";
+		sendAll(fd, out.str());
+		return ch;
+	}
+
+private:
+	int fd;
+	double start;
+	string line;
+};
+
+static bool parseRequest(const vector<string> &words, SolveRequest &req, string &error)
+{
+	//The defaults of main()
+	req.byHash = false;
+	req.hash = 0;
+	req.algorithm = 1;
+	req.tenure = 0;
+	req.randomSeed = 1;
+	req.targetCols = 1;
+	req.constructiveAlg = 1;
+	req.strategy = KSEARCH_LINEAR;
+	req.lowerBound = 1;
+	req.cliqueMode = CLIQUE_GREEDY;
+	req.fixedK = 0;
+	req.reduce = false;
+	req.components = false;
+	req.maxChecks = INT_MAX;
+	req.timeLimit = req.kTimeLimit = 0;
+
+	for (size_t i = 1; i < words.size(); i++) {
+		bool hasValue = i + 1 < words.size();
+		const char *value = hasValue ? words[i + 1].c_str() : "";
+		if (words[i] == "-t") req.algorithm = 2;
+		else if (words[i] == "-tt") req.tenure++;
+		else if (words[i] == "--reduce") req.reduce = true;
+		else if (words[i] == "--components") req.components = true;
+		else if (words[i][0] == '-' && !hasValue) {
+			error = "missing value for " + words[i];
+			return false;
+		}
+		else if (words[i] == "-s") { req.maxChecks = strtoull(value, NULL, 10); i++; }
+		else if (words[i] == "-r") { req.randomSeed = atoi(value); i++; }
+		else if (words[i] == "-T") { req.targetCols = atoi(value); i++; }
+		else if (words[i] == "-k") { req.fixedK = atoi(value); i++; }
+		else if (words[i] == "-a") { req.constructiveAlg = atoi(value); i++; }
+		else if (words[i] == "--k-search") { req.strategy = atoi(value); i++; }
+		else if (words[i] == "--lower-bound") { req.lowerBound = atoi(value); i++; }
+		else if (words[i] == "--clique") { req.cliqueMode = atoi(value); i++; }
+		else if (words[i] == "--time-limit") { req.timeLimit = atof(value); i++; }
+		else if (words[i] == "--k-time-limit") { req.kTimeLimit = atof(value); i++; }
+		else if (words[i] == "--precolour") { req.precolour = value; i++; }
+		else if (words[i] == "--graph-hash") { req.hash = strtoull(value, NULL, 16); req.byHash = true; i++; }
+		else if (words[i][0] == '-') {
+			error = "option " + words[i] + " cannot be used with the daemon";
+			return false;
+		}
+		else req.graphFile = words[i];
+	}
+	if (req.cliqueMode < CLIQUE_NONE || req.cliqueMode > CLIQUE_EXACT) {
+		error = "bad --clique mode";
+		return false;
+	}
+	if (req.graphFile.empty() && !req.byHash) {
+		error = "no graph file";
+		return false;
+	}
+	return true;
+}
+
+static shared_ptr<LoadedGraph> findGraph(DaemonState &d, SolveRequest &req, bool &cached, string &error)
+{
+	//The hash of a file is kept with its size and modification time, so a graph that is already
+	//loaded is found without reading the file again
+	if (!req.byHash) {
+		struct stat st;
+		if (stat(req.graphFile.c_str(), &st) != 0) {
+			error = "cannot open graph file " + req.graphFile;
+			return shared_ptr<LoadedGraph>();
+		}
+		bool known = false;
+		{
+			lock_guard<mutex> guard(d.lock);
+			map<string, FileStamp>::iterator it = d.files.find(req.graphFile);
+			if (it != d.files.end() && it->second.size == (long long)st.st_size && it->second.mtime == (long long)st.st_mtime) {
+				req.hash = it->second.hash;
+				known = true;
+			}
+		}
+		if (!known) {
+			bool ok;
+			req.hash = hashGraphFile(req.graphFile.c_str(), ok);
+			if (!ok) {
+				error = "cannot open graph file " + req.graphFile;
+				return shared_ptr<LoadedGraph>();
+			}
+			FileStamp stamp = { (long long)st.st_size, (long long)st.st_mtime, req.hash };
+			lock_guard<mutex> guard(d.lock);
+			d.files[req.graphFile] = stamp;
+		}
+	}
+
+	{
+		lock_guard<mutex> guard(d.lock);
+		for (list< shared_ptr<LoadedGraph> >::iterator it = d.graphs.begin(); it != d.graphs.end(); it++) {
+			if ((*it)->hash == req.hash) {
+				d.graphs.splice(d.graphs.begin(), d.graphs, it);
+				cached = true;
+				return d.graphs.front();
+			}
+		}
+	}
+	if (req.byHash) {
+		error = "graph " + hexHash(req.hash) + " is not loaded";
+		return shared_ptr<LoadedGraph>();
+	}
+
+	//Read it outside the lock, so that other requests carry on meanwhile
+	shared_ptr<LoadedGraph> lg(new LoadedGraph);
+	lg->hash = req.hash;
+	if (!readDimacsGraph(lg->g, req.graphFile.c_str(), error)) {
+		while (!error.empty() && error[error.size() - 1] == '\n') error.erase(error.size() - 1);
+		for (size_t i = 0; i < error.size(); i++) if (error[i] == '\n') error[i] = ' ';
+		return shared_ptr<LoadedGraph>();
+	}
+	lg->neighbors = new int*[lg->g.n];
+	makeAdjList(lg->neighbors, lg->g);
+	cached = false;
+
+	lock_guard<mutex> guard(d.lock);
+	for (list< shared_ptr<LoadedGraph> >::iterator it = d.graphs.begin(); it != d.graphs.end(); it++) {
+		if ((*it)->hash == req.hash) {
+			//Another request has loaded it meanwhile
+			d.graphs.splice(d.graphs.begin(), d.graphs, it);
+			return d.graphs.front();
+		}
+	}
+	d.graphs.push_front(lg);
+	//A graph dropped here stays alive until the requests using it are done
+	while ((int)d.graphs.size() > d.cacheSize) d.graphs.pop_back();
+	return lg;
+}
+
+// The graph h in which the precoloured vertices of g with the same colour are merged into one
+// vertex, these vertices forming a clique. Any colouring of h gives a colouring of g that respects
+// the precolouring. vertexOf[v] is the vertex of h standing for v, and the vertices of h from
+// h.n - labels.size() stand for the colours labels[0], labels[1], ...
+static bool mergePrecoloured(LoadedGraph &lg, const string &text, Graph &h, vector<int> &vertexOf, vector<int> &labels, string &error)
+{
+	Graph &g = lg.g;
+	vector<int> colour(g.n, -1);
+	map<int, int> labelIndex;
+	size_t pos = 0;
+	while (pos < text.size()) {
+		size_t end = text.find(',', pos);
+		if (end == string::npos) end = text.size();
+		int v, c;
+		if (sscanf(text.substr(pos, end - pos).c_str(), "%d=%d", &v, &c) != 2 || v < 1 || v > g.n || c < 0) {
+			error = "bad precolouring entry " + text.substr(pos, end - pos);
+			return false;
+		}
+		if (colour[v - 1] >= 0 && colour[v - 1] != c) {
+			error = "vertex " + to_string(v) + " is precoloured twice";
+			return false;
+		}
+		colour[v - 1] = c;
+		labelIndex[c] = 0;
+		pos = end + 1;
+	}
+	labels.clear();
+	for (map<int, int>::iterator it = labelIndex.begin(); it != labelIndex.end(); it++) {
+		it->second = (int)labels.size();
+		labels.push_back(it->first);
+	}
+
+	int numFree = 0;
+	vertexOf.resize(g.n);
+	for (int v = 0; v < g.n; v++) if (colour[v] < 0) vertexOf[v] = numFree++;
+	for (int v = 0; v < g.n; v++) if (colour[v] >= 0) vertexOf[v] = numFree + labelIndex[colour[v]];
+
+	h.resize(numFree + (int)labels.size());
+	for (int v = 0; v < g.n; v++) {
+		for (int j = 1; j <= lg.neighbors[v][0]; j++) {
+			int u = lg.neighbors[v][j];
+			if (vertexOf[u] == vertexOf[v]) {
+				error = "precoloured vertices " + to_string(v + 1) + " and " + to_string(u + 1) + " are adjacent and have the same colour";
+				return false;
+			}
+			h[vertexOf[v]][vertexOf[u]] = 1;
+		}
+	}
+	for (int a = numFree; a < h.n; a++)
+		for (int b = numFree; b < h.n; b++)
+			if (a != b) h[a][b] = 1;
+	h.nbEdges = 0;
+	for (int a = 0; a < h.n; a++)
+		for (int b = a + 1; b < h.n; b++) h.nbEdges += h[a][b];
+	return true;
+}
+
+static void solve(DaemonState &d, int fd, const vector<string> &words)
+{
+	SolveRequest req;
+	string error;
+	bool cached = false;
+	shared_ptr<LoadedGraph> lg;
+	if (parseRequest(words, req, error)) lg = findGraph(d, req, cached, error);
+	if (lg == NULL) {
+		sendAll(fd, "ERROR " + error + "\n");
+		return;
+	}
+	ostringstream head;
+	head << "GRAPH " << hexHash(lg->hash) << " " << lg->g.n << " " << lg->g.nbEdges << (cached ? " cached" : " loaded") << "\n";
+	sendAll(fd, head.str());
+
+	//With a precolouring the search is made on the graph with the precoloured vertices merged
+	Graph merged;
+	int **mergedNeighbors = NULL;
+	vector<int> vertexOf, labels;
+	Graph *g = &lg->g;
+	int **neighbors = lg->neighbors;
+	if (!req.precolour.empty()) {
+		if (!mergePrecoloured(*lg, req.precolour, merged, vertexOf, labels, error)) {
+			sendAll(fd, "ERROR " + error + "\n");
+			return;
+		}
+		mergedNeighbors = new int*[merged.n];
+		makeAdjList(mergedNeighbors, merged);
+		g = &merged;
+		neighbors = mergedNeighbors;
+	}
+
+	if (g->n > 0) {
+		//Wait for a free worker
+		{
+			unique_lock<mutex> guard(d.lock);
+			while (d.running >= d.numWorkers) d.cond.wait(guard);
+			d.running++;
+			lg->requests++;
+		}
+
+		KSearchParams p;
+		p.strategy = req.strategy;
+		p.algorithm = req.algorithm;
+		p.tenure = req.tenure;
+		p.verbose = 0;
+		p.frequency = 0;
+		p.increment = 0;
+		p.targetCols = req.targetCols < 2 || req.targetCols > g->n ? 2 : req.targetCols;
+		if (req.fixedK > 0) p.targetCols = req.fixedK;
+		//The clique of the graph also bounds the graph with the precoloured vertices merged, since
+		//its colourings are colourings of the graph. The workers are busy with the other requests,
+		//so the clique is grown on this thread only.
+		{
+			lock_guard<mutex> guard(lg->cliqueLock);
+			if (lg->clique[req.cliqueMode] == 0) {
+				bool proven;
+				lg->clique[req.cliqueMode] = cliqueBound(lg->g, lg->neighbors, req.cliqueMode, 1, proven);
+			}
+		}
+		p.lowerBound = max(req.lowerBound, lg->clique[req.cliqueMode]);
+		p.maxChecks = req.maxChecks;
+		p.clockType = CLOCK_WALL;
+		p.timeLimit = req.timeLimit;
+		p.kTimeLimit = req.kTimeLimit;
+		p.pool = NULL;
+		p.checkpoint = NULL;
+		p.trace = NULL;
+		p.solution = NULL;
+		p.reduce = req.reduce;
+		p.components = req.components;
+		p.componentPool = NULL;
+
+		vector<int> colouring(g->n);
+		ProgressBuf progress(fd, readClock(CLOCK_WALL));
+		ostream confStream(&progress), timeStream(NULL);
+		rngState = 1;
+		RunResult r = solveRun(*g, neighbors, req.constructiveAlg, req.randomSeed, p, &colouring[0], confStream, timeStream, req.fixedK);
+
+		{
+			lock_guard<mutex> guard(d.lock);
+			d.running--;
+			d.solves++;
+			d.cond.notify_all();
+		}
+
+		//Back to the vertices of the graph, the merged vertices getting the colours asked for and
+		//the other colours the lowest values not used by the precolouring
+		if (!labels.empty()) {
+			vector<int> relabel(g->n, -1);
+			set<int> used(labels.begin(), labels.end());
+			int numFree = g->n - (int)labels.size();
+			for (size_t i = 0; i < labels.size(); i++) relabel[colouring[numFree + i]] = labels[i];
+			int next = 0;
+			for (int c = 0; c < g->n; c++) {
+				if (relabel[c] >= 0) continue;
+				while (used.count(next)) next++;
+				relabel[c] = next++;
+			}
+			vector<int> original(lg->g.n);
+			for (int v = 0; v < lg->g.n; v++) original[v] = relabel[colouring[vertexOf[v]]];
+			colouring.swap(original);
+		}
+
+		ostringstream out;
+		out << "RESULT startK=" << r.startK << " bestK=" << r.bestK << " reached=" << r.reached << " checks=" << r.checks
+			<< " seconds=" << r.seconds << "\nCOLOURING";
+		for (size_t i = 0; i < colouring.size(); i++) out << ' ' << colouring[i];
+		out << "\n";
+		sendAll(fd, out.str());
+		if (d.verbose >= 1) cout << "Solved " << hexHash(lg->hash) << (req.byHash ? "" : " (" + req.graphFile + ")") << ": " << r.startK << " -> " << r.bestK << " colours in " << r.seconds << "s" << endl;
+	}
+	else sendAll(fd, "RESULT startK=0 bestK=0 reached=1 checks=0 seconds=0\nCOLOURING\n");
+
+	if (mergedNeighbors != NULL) {
+		for (int i = 0; i < merged.n; i++) delete[] mergedNeighbors[i];
+		delete[] mergedNeighbors;
+	}
+}
+
+static void sendStats(DaemonState &d, int fd)
+{
+	ostringstream out;
+	lock_guard<mutex> guard(d.lock);
+	for (list< shared_ptr<LoadedGraph> >::iterator it = d.graphs.begin(); it != d.graphs.end(); it++)
+		out << "GRAPH " << hexHash((*it)->hash) << " " << (*it)->g.n << " " << (*it)->g.nbEdges << " " << (*it)->requests << "\n";
+	out << "STATS graphs=" << d.graphs.size() << " solves=" << d.solves << " running=" << d.running << "\n";
+	sendAll(fd, out.str());
+}
+
+static void stopDaemon(DaemonState &d)
+{
+	//Wake up accept(), and let the other connections end after their current request
+	lock_guard<mutex> guard(d.lock);
+	d.stop = true;
+	shutdown(d.listenFd, SHUT_RDWR);
+	for (set<int>::iterator it = d.connections.begin(); it != d.connections.end(); it++) shutdown(*it, SHUT_RD);
+}
+
+static void serveConnection(DaemonState &d, int fd)
+{
+	string buffer;
+	char chunk[65536];
+	bool open = true;
+	while (open) {
+		size_t eol;
+		while ((eol = buffer.find('\n')) == string::npos && buffer.size() <= MAX_REQUEST) {
+			ssize_t r = recv(fd, chunk, sizeof(chunk), 0);
+			if (r < 0 && errno == EINTR) continue;
+			if (r <= 0) break;
+			buffer.append(chunk, r);
+		}
+		if (eol == string::npos) break;
+
+		istringstream in(buffer.substr(0, eol));
+		buffer.erase(0, eol + 1);
+		vector<string> words;
+		string w;
+		while (in >> w) words.push_back(w);
+		if (words.empty()) continue;
+		if (words[0] == "SOLVE") solve(d, fd, words);
+		else if (words[0] == "STATS") sendStats(d, fd);
+		else if (words[0] == "SHUTDOWN") stopDaemon(d);
+		else sendAll(fd, "ERROR unknown request " + words[0] + "\n");
+		open = sendAll(fd, "END\n");
+	}
+
+	close(fd);
+	//The search arrays kept by this thread would otherwise be lost with it
+	releaseArrayCache();
+	lock_guard<mutex> guard(d.lock);
+	d.connections.erase(fd);
+	d.cond.notify_all();
+}
+
+int runDaemon(const char *socketPath, int numWorkers, int cacheSize, int verbose)
+{
+	sockaddr_un addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	if (strlen(socketPath) >= sizeof(addr.sun_path)) {
+		cout << "ERROR: the socket path " << socketPath << " is too long" << endl;
+		return 1;
+	}
+	strcpy(addr.sun_path, socketPath);
+
+	//A socket file left by a daemon that is no longer running is replaced
+	int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (probe >= 0 && connect(probe, (sockaddr *)&addr, sizeof(addr)) == 0) {
+		close(probe);
+		cout << "ERROR: a daemon is already listening on " << socketPath << endl;
+		return 1;
+	}
+	if (probe >= 0) close(probe);
+	unlink(socketPath);
+
+	DaemonState d;
+	d.listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (d.listenFd < 0 || bind(d.listenFd, (sockaddr *)&addr, sizeof(addr)) != 0 || listen(d.listenFd, 64) != 0) {
+		cout << "ERROR: cannot listen on " << socketPath << ": " << strerror(errno) << endl;
+		return 1;
+	}
+	d.numWorkers = numWorkers < 1 ? 1 : numWorkers;
+	d.cacheSize = cacheSize < 1 ? 1 : cacheSize;
+	d.verbose = verbose;
+	d.running = 0;
+	d.solves = 0;
+	d.stop = false;
+
+	//A client that goes away must not end the daemon
+	signal(SIGPIPE, SIG_IGN);
+	if (verbose >= 1) cout << "Listening on " << socketPath << " (" << d.numWorkers << " workers, " << d.cacheSize << " graphs kept)" << endl;
+
+	while (true) {
+		int fd = accept(d.listenFd, NULL, NULL);
+		lock_guard<mutex> guard(d.lock);
+		if (d.stop) {
+			if (fd >= 0) close(fd);
+			break;
+		}
+		if (fd < 0) {
+			if (errno == EINTR || errno == ECONNABORTED) continue;
+			cout << "ERROR: accept failed: " << strerror(errno) << endl;
+			break;
+		}
+		d.connections.insert(fd);
+		thread(serveConnection, ref(d), fd).detach();
+	}
+
+	//The connection threads use d, so wait for them
+	{
+		unique_lock<mutex> guard(d.lock);
+		while (!d.connections.empty()) d.cond.wait(guard);
+	}
+	close(d.listenFd);
+	unlink(socketPath);
+	if (verbose >= 1) cout << d.solves << " requests solved" << endl;
+	return 0;
+}
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef DAEMON_INCLUDED
+#define DAEMON_INCLUDED
+
+// --daemon <socket>: stays running and solves the requests sent to the Unix-domain socket <socket>
+// (see solveClient). The graphs are kept in memory between requests, keyed by the hash of their
+// file, so that a graph is only read and set up once; at most cacheSize of them are kept, the least
+// recently used being dropped first. At most numWorkers requests are solved at the same time.
+// Returns 0 after a SHUTDOWN request, or 1 if the socket could not be set up.
+//
+// A connection sends requests of one line each, every answer ending with the line "END":
+//   SOLVE <options> <graph file>   or   SOLVE <options> --graph-hash <hash>
+//       The options are those of PartialColAndTabuCol (-t -tt -s -r -T -a --k-search --lower-bound
+//       --clique --time-limit --k-time-limit --reduce --components), plus "-k <int>" (only attempt k colours) and
+//       "--precolour v=c,v=c,..." (vertex v, from 1, must get colour c). One run is made for the seed.
+//       Answer: GRAPH <hash> <nodes> <edges> loaded|cached
+//               PROGRESS k=<k> checks=<checks> seconds=<s> [failed]   (one per value of k)
+//               RESULT startK=<k> bestK=<k> reached=0|1 checks=<checks> seconds=<s>
+//               COLOURING <colour of vertex 1> ... <colour of vertex n>
+//   STATS     Answer: one "GRAPH <hash> <nodes> <edges> <requests>" line per graph kept, then
+//             "STATS graphs=<n> solves=<n> running=<n>"
+//   SHUTDOWN  The daemon stops once the running requests have been answered
+// A request that cannot be served is answered by "ERROR <message>".
+int runDaemon(const char *socketPath, int numWorkers, int cacheSize, int verbose);
+
+#endif
@@ -1,11 +1,12 @@
 #include "initializeColoring.h"
+#include "checkCounter.h"
+#include "rng.h"
 #include <stdlib.h>
 #include <limits.h>
+#include <algorithm>
 
 using namespace std;
 
-extern unsigned long long numConfChecks;
-
 inline
 void swap(int &a, int &b) {
 	int temp;
@@ -13,65 +14,52 @@ void swap(int &a, int &b) {
 }
 
 inline
-bool colourIsFeasible(int v, vector< vector<int> > &sol, int c, vector<int> &colNode, vector< vector<int> > &adjList, Graph &g)
+int lowestBit(unsigned long long x)
 {
-	//Checks to see whether vertex v can be feasibly inserted into colour c in sol.	
-	int i;
-	numConfChecks++;
-	if(sol[c].size() > adjList[v].size()){
-		//check if any neighbours of v are currently in colour c
-		for(i=0; i<adjList[v].size(); i++){
-			numConfChecks++;
-			if(colNode[adjList[v][i]] == c) return false;
-		}
-		return true;
-	}
-	else {
-		//check if any vertices in colour c are adjacent to v
-		for(i=0; i<sol[c].size(); i++){
-			numConfChecks++;
-			if(g[v][sol[c][i]]) return false;
-		}
-		return true;
-	}
+#if defined(__GNUC__)
+	return __builtin_ctzll(x);
+#else
+	int b = 0;
+	while (!(x & 1)) { x >>= 1; b++; }
+	return b;
+#endif
 }
 
 inline
-void assignAColourDSatur(bool &foundColour, vector< vector<int> > &candSol, vector<int> &permutation, int nodePos, vector<int> &satDeg, Graph &g, vector<int> &colNode, vector< vector<int> > &adjList)
+int highestBit(unsigned long long x)
 {
-	int i, j, c=0, v=permutation[nodePos];
-	bool alreadyAdj;
-
-	while(c < candSol.size() && !foundColour){			
-		//check if colour c is feasible for vertex v
-		if(colourIsFeasible(v, candSol, c, colNode, adjList, g)){
-			//v can be added to this colour
-			foundColour = true;
-			candSol[c].push_back(v);
-			colNode[v] = c;
-			//We now need to update satDeg. To do this we identify the uncloured nodes i that are adjacent to
-			//this newly coloured node v. If i is already adjacent to a node in colour c we do nothing, 
-			//otherwise its saturation degree is increased...
-			for(i=0; i<satDeg.size(); i++){
-				numConfChecks++;
-				if(g[v][permutation[i]]){
-					alreadyAdj = false;
-					j=0;
-					while(j<candSol[c].size()-1 && !alreadyAdj){
-						numConfChecks++;
-						if(g[candSol[c][j]][permutation[i]]) alreadyAdj = true;
-						j++;
-					}
-					if (!alreadyAdj)
-						satDeg[i]++;
-				}
-			}
-		}
-		c++;
-	}
+#if defined(__GNUC__)
+	return 63 - __builtin_clzll(x);
+#else
+	int b = 0;
+	while (x >>= 1) b++;
+	return b;
+#endif
+}
+
+inline
+int lowestFreeColour(vector<unsigned long long> &used)
+{
+	//Returns the smallest colour whose bit is not set in used
+	size_t w = 0;
+	while (w < used.size() && used[w] == ~0ULL) w++;
+	if (w == used.size()) return (int)w * 64;
+	return (int)w * 64 + lowestBit(~used[w]);
+}
+
+inline
+bool setColourBit(vector<unsigned long long> &used, int c)
+{
+	//Sets the bit of colour c, returning false if it was set already
+	size_t w = c / 64;
+	unsigned long long bit = 1ULL << (c % 64);
+	if (used.size() <= w) used.resize(w + 1, 0);
+	if (used[w] & bit) return false;
+	used[w] |= bit;
+	return true;
 }
 
-inline 
+inline
 void greedyCol(vector< vector<int> > &candSol, vector<int> &colNode, Graph &g, vector< vector<int> > &adjList)
 {
 	//1) Make an empty vector representing all the unplaced nodes (i.e. all of them) and permute
@@ -79,40 +67,82 @@ void greedyCol(vector< vector<int> > &candSol, vector<int> &colNode, Graph &g, v
 	vector<int> a(g.n);
 	for (i=0;i<g.n;i++) a[i]=i;
 	for(i=g.n-1; i>=0; i--){	
-		r = rand()%(i+1);
+		r = randomInt()%(i+1);
 		swap(a[i],a[r]); 
 	}
 
-	//Now colour using the greedy algorithm. First, place the first node into the first group
+	//For each node, a bitset of the colours that are forbidden because a neighbour already has them
+	vector< vector<unsigned long long> > forbidden(g.n);
+
+	//Now colour using the greedy algorithm: each node in turn goes into the lowest colour that is not forbidden,
+	//which is a new colour if all existing ones are
 	candSol.clear();
-	candSol.push_back(vector<int>());
-	candSol[0].push_back(a[0]);
-	colNode[a[0]] = 0;
-
-	//Now go through the remaining nodes and see if they are suitable for any existing colour. If it isn't, we create a new colour 
-	for(i=1; i<g.n; i++){
-		for(j=0; j<candSol.size(); j++){
-			if(colourIsFeasible(a[i], candSol, j, colNode, adjList, g)){
-				//the Item can be inserted into this group. So we do
-				candSol[j].push_back(a[i]);
-				colNode[a[i]] = j;
-				break;
-			}
-		}
-		if(j>=candSol.size()){
-			//If we are here then the item could not be inserted into any of the existing groups. So we make a new one
-			candSol.push_back(vector<int>());
-			candSol.back().push_back(a[i]);
-			colNode[a[i]] = candSol.size()-1;
+	for(i=0; i<g.n; i++){
+		int v = a[i];
+		int c = lowestFreeColour(forbidden[v]);
+		if (c == (int)candSol.size()) candSol.push_back(vector<int>());
+		candSol[c].push_back(v);
+		colNode[v] = c;
+		vector<unsigned long long>().swap(forbidden[v]);
+		//Forbid c for the neighbours that are still to be coloured
+		numConfChecks += adjList[v].size();
+		for(j=0; j<(int)adjList[v].size(); j++){
+			int u = adjList[v][j];
+			if (colNode[u] == INT_MAX) setColourBit(forbidden[u], c);
 		}
 	}
 }
 
+// The uncoloured nodes of DSatur, grouped by saturation degree. Each level is a bitmap over the positions of
+// the nodes in the permutation, with one summary bit per non-empty word, so moving a node up one level is O(1)
+// and the rightmost node of the highest level is found by scanning n/4096 summary words.
+class SaturationBuckets {
+public:
+	SaturationBuckets(int n) : numWords((n + 63) / 64), top(0) { }
+
+	void insert(int level, int pos)
+	{
+		while ((int)bits.size() <= level) {
+			bits.push_back(vector<unsigned long long>(numWords, 0));
+			summary.push_back(vector<unsigned long long>((numWords + 63) / 64, 0));
+			count.push_back(0);
+		}
+		bits[level][pos / 64] |= 1ULL << (pos % 64);
+		summary[level][pos / 4096] |= 1ULL << ((pos / 64) % 64);
+		count[level]++;
+		if (level > top) top = level;
+	}
+
+	void remove(int level, int pos)
+	{
+		unsigned long long &word = bits[level][pos / 64];
+		word &= ~(1ULL << (pos % 64));
+		if (word == 0) summary[level][pos / 4096] &= ~(1ULL << ((pos / 64) % 64));
+		count[level]--;
+	}
+
+	// Removes and returns the largest position in the highest non-empty level
+	int popRightmost()
+	{
+		while (count[top] == 0) top--;
+		int s = (int)summary[top].size() - 1;
+		while (summary[top][s] == 0) s--;
+		int w = s * 64 + highestBit(summary[top][s]);
+		int pos = w * 64 + highestBit(bits[top][w]);
+		remove(top, pos);
+		return pos;
+	}
+
+private:
+	int numWords, top;
+	vector< vector<unsigned long long> > bits, summary;
+	vector<int> count;
+};
+
 inline
 void DSaturCol(vector< vector<int> > &candSol, vector<int> &colNode, Graph &g, vector< vector<int> > &adjList)
 {
-	int i, j, r;
-	bool foundColour;
+	int i, r;
 	
 	//Make a vector representing all the nodes
 	vector<int> permutation(g.n);
@@ -120,74 +150,138 @@ void DSaturCol(vector< vector<int> > &candSol, vector<int> &colNode, Graph &g, v
 	//Randomly permute the nodes, and then arrange by increasing order of degree
 	//(this allows more than 1 possible outcome from the sort procedure)
 	for(i=permutation.size()-1; i>=0; i--){
-		r = rand()%(i+1);
+		r = randomInt()%(i+1);
 		swap(permutation[i],permutation[r]);
 	}
-	//Bubble sort is used here. This could be made more efficent
-	for(i=(permutation.size()-1); i>=0; i--){
-		for(j=1; j<=i; j++){
-			numConfChecks+=2;
-			if(adjList[permutation[j-1]].size() > adjList[permutation[j]].size()){
-				swap(permutation[j-1],permutation[j]);
-			}
-		}
-	}
-	
-	//We also have a vector to hold the saturation degrees of each node
-	vector<int> satDeg(permutation.size(), 0);
+	stable_sort(permutation.begin(), permutation.end(), [&](int a, int b) { return adjList[a].size() < adjList[b].size(); });
+
+	//Among nodes of equal saturation degree the one furthest right in the permutation is coloured first
+	vector<int> position(g.n);
+	for (i=0;i<g.n;i++) position[permutation[i]] = i;
+	vector<int> satDeg(g.n, 0);
+	SaturationBuckets uncoloured(g.n);
+	for (i=0;i<g.n;i++) uncoloured.insert(0, i);
+
+	//For each node, a bitset of the colours already used by its neighbours
+	vector< vector<unsigned long long> > adjColours(g.n);
 
 	//Initialise candSol and colNode
 	candSol.clear();
-	candSol.push_back(vector<int>());
 	for(i=0; i<colNode.size(); i++) colNode[i] = INT_MIN;
-	
-	//Colour the rightmost node first (it has the highest degree), and remove it from the permutation
-	candSol[0].push_back(permutation.back());
-	colNode[permutation.back()] = 0;
-	permutation.pop_back();
-	//..and update the saturation degree array
-	satDeg.pop_back();
-	for(i=0; i<satDeg.size(); i++){
-		numConfChecks++;
-		if(g[candSol[0][0]][permutation[i]]){
-			satDeg[i]++;
+
+	for (int numColoured=0; numColoured<g.n; numColoured++){
+		//choose the node to colour next (the rightmost node that has maximal satDegree)
+		int v = permutation[uncoloured.popRightmost()];
+		//it gets the lowest colour not used by its neighbours, which may be a new one
+		int c = lowestFreeColour(adjColours[v]);
+		if (c == (int)candSol.size()) candSol.push_back(vector<int>());
+		candSol[c].push_back(v);
+		colNode[v] = c;
+		//The saturation degree of an uncoloured neighbour goes up if c is new in its neighbourhood
+		numConfChecks += adjList[v].size();
+		for (i=0; i<(int)adjList[v].size(); i++) {
+			int u = adjList[v][i];
+			if (colNode[u] != INT_MIN || !setColourBit(adjColours[u], c)) continue;
+			uncoloured.remove(satDeg[u], position[u]);
+			uncoloured.insert(++satDeg[u], position[u]);
 		}
+		vector<unsigned long long>().swap(adjColours[v]);
 	}
-	
-	//Now colour the remaining nodes.
-	int nodePos = 0, maxSat;
-	while(!permutation.empty()){
-		//choose the node to colour next (the rightmost node that has maximal satDegree)
-		maxSat = INT_MIN;
-		for(i=0; i<satDeg.size(); i++){
-			if(satDeg[i] >= maxSat){
-				maxSat = satDeg[i];
-				nodePos = i;
-			}
+}
+
+inline
+void RLFCol(vector< vector<int> > &candSol, vector<int> &colNode, Graph &g, vector< vector<int> > &adjList)
+{
+	//Recursive Largest First. Colour classes are built one at a time: among the uncoloured nodes, W holds those
+	//that can still join the current class and Y those that have a neighbour in it. degW[v] and degY[v] count the
+	//neighbours of an uncoloured node v in W and in Y, and are updated as nodes leave W.
+	int i, j, r;
+	vector<int> rank(g.n);
+	for (i=0;i<g.n;i++) rank[i]=i;
+	//Remaining ties are broken by a random ranking of the nodes
+	for(i=g.n-1; i>=0; i--){
+		r = randomInt()%(i+1);
+		swap(rank[i],rank[r]);
+	}
+
+	const char COLOURED = 0, IN_W = 1, IN_Y = 2;
+	vector<char> state(g.n, IN_W);
+	vector<int> degW(g.n), degY(g.n, 0);
+	vector<int> W(g.n), wPosition(g.n), Y;
+	for (i=0;i<g.n;i++) {
+		W[i] = i;
+		wPosition[i] = i;
+		degW[i] = adjList[i].size();
+	}
+	numConfChecks += g.n;
+
+	candSol.clear();
+	while (!W.empty()) {
+		int c = candSol.size();
+		candSol.push_back(vector<int>());
+
+		//The class starts with the node of largest degree in the subgraph of uncoloured nodes
+		int v = -1;
+		for (i=0; i<(int)W.size(); i++) {
+			int u = W[i];
+			if (v == -1 || degW[u] > degW[v] || (degW[u] == degW[v] && rank[u] > rank[v])) v = u;
 		}
-		//now choose which colour to assign to the node
-		foundColour = false;
-		assignAColourDSatur(foundColour, candSol, permutation, nodePos, satDeg, g, colNode, adjList);
-		if(!foundColour){	
-			//If we are here we have to make a new colour as we have tried all the other ones and none are suitable
-			candSol.push_back(vector<int>());
-			candSol.back().push_back(permutation[nodePos]);
-			colNode[permutation[nodePos]] = candSol.size()-1;
-			//Remember to update the saturation degree array
-			for(i=0; i<permutation.size(); i++){
-				numConfChecks++;
-				if(g[permutation[nodePos]][permutation[i]]){
-					satDeg[i]++;
+
+		while (v != -1) {
+			//Put v in the class and take it out of W
+			candSol[c].push_back(v);
+			colNode[v] = c;
+			state[v] = COLOURED;
+			W[wPosition[v]] = W.back();
+			wPosition[W.back()] = wPosition[v];
+			W.pop_back();
+			numConfChecks += adjList[v].size();
+			for (i=0; i<(int)adjList[v].size(); i++) {
+				int u = adjList[v][i];
+				if (state[u] != COLOURED) degW[u]--;
+			}
+			//Its neighbours in W can no longer join the class, so they move to Y
+			for (i=0; i<(int)adjList[v].size(); i++) {
+				int u = adjList[v][i];
+				if (state[u] != IN_W) continue;
+				state[u] = IN_Y;
+				Y.push_back(u);
+				W[wPosition[u]] = W.back();
+				wPosition[W.back()] = wPosition[u];
+				W.pop_back();
+				numConfChecks += adjList[u].size();
+				for (j=0; j<(int)adjList[u].size(); j++) {
+					int w = adjList[u][j];
+					if (state[w] != COLOURED) {
+						degW[w]--;
+						degY[w]++;
+					}
 				}
 			}
+			//The next node is the one in W with most neighbours in Y, then fewest in W
+			v = -1;
+			for (i=0; i<(int)W.size(); i++) {
+				int u = W[i];
+				if (v == -1 || degY[u] > degY[v] || (degY[u] == degY[v] && (degW[u] < degW[v] || (degW[u] == degW[v] && rank[u] > rank[v])))) v = u;
+			}
+		}
+
+		//The class is complete: the nodes of Y are the uncoloured nodes for the next one
+		for (i=0; i<(int)Y.size(); i++) {
+			int u = Y[i];
+			state[u] = IN_W;
+			wPosition[u] = W.size();
+			W.push_back(u);
+		}
+		for (i=0; i<(int)W.size(); i++) {
+			degW[W[i]] += degY[W[i]];
+			degY[W[i]] = 0;
 		}
-		//Finally, we remove the node from the permutation
-		permutation.erase(permutation.begin() + nodePos);
-		satDeg.erase(satDeg.begin() + nodePos);
+		Y.clear();
 	}
 }
 
-int generateInitialK(Graph &g, int alg, int *bestColouring)
+int generateInitialK(Graph &g, int alg, int *bestColouring, int **neighbors)
 {
 	//Produce an solution using a constructive algorithm to get an intial setting for k
 	int i, j;
@@ -196,14 +290,11 @@ int generateInitialK(Graph &g, int alg, int *bestColouring)
 	vector< vector<int> > candSol, adjList(g.n,vector<int>());
 	vector<int> colNode(g.n, INT_MAX);
 	for(i=0; i<g.n; i++){
-		for(j=0; j<g.n; j++){
-			if(g[i][j] && i!=j){
-				adjList[i].push_back(j);
-			}
-		}
+		adjList[i].assign(neighbors[i] + 1, neighbors[i] + 1 + neighbors[i][0]);
 	}
 	//Now make the solution
 	if(alg == 1) DSaturCol(candSol,colNode,g,adjList);
+	else if(alg == 3) RLFCol(candSol,colNode,g,adjList);
 	else greedyCol(candSol,colNode,g,adjList);
 	//Copy this solution into bestColouring
 	for(i=0;i<candSol.size();i++) for(j=0;j<candSol[i].size();j++) bestColouring[candSol[i][j]] = i;
@@ -211,7 +302,7 @@ int generateInitialK(Graph &g, int alg, int *bestColouring)
 	return candSol.size();
 }
 
-void initializeColoring(Graph & g, int * c, int k) 
+void initializeColoring(Graph & g, int * c, int k, int ** neighbors)
 {
 	// A simple greedy algorithm that leaves the assigned color if possible, gives another legal color or 
 	// assigns color 0 if nothing else is available.
@@ -221,7 +312,7 @@ void initializeColoring(Graph & g, int * c, int k)
 		perm[i] = i;
 	}
 	for (int i=0; i<g.n; i++) {
-		int p = rand()%g.n;
+		int p = randomInt()%g.n;
 		int h = perm[i];
 		perm[i] = perm[p];
 		perm[p] = h;
@@ -241,11 +332,9 @@ void initializeColoring(Graph & g, int * c, int k)
 		for (int j=0; j<=k; j++) {
 			taken[j]=0;
 		}
-		for (int j=0; j<g.n; j++) {
-			numConfChecks++;
-			if (i!=j && g[i][j]) {
-				taken[c[j]]++;
-			}
+		numConfChecks += neighbors[i][0];
+		for (int j=1; j<=neighbors[i][0]; j++) {
+			taken[c[neighbors[i][j]]]++;
 		}
 		// if the currently assigned color is legal and not 0, leave it
 		// otherwise find a new legal color, and if not possible set it to zero.
@@ -264,7 +353,7 @@ void initializeColoring(Graph & g, int * c, int k)
 	delete [] taken;
 }
 
-void initializeColoringForTabu(Graph & g, int * c, int k)
+void initializeColoringForTabu(Graph & g, int * c, int k, int ** neighbors)
 {
 	// A simple greedy algorithm that leaves the assigned color  if possible, gives another legal color or 
 	// assigns a random color if nothing else is available.
@@ -274,7 +363,7 @@ void initializeColoringForTabu(Graph & g, int * c, int k)
 		perm[i] = i;
 	}
 	for (int i=0; i<g.n; i++) {
-		int p = rand()%g.n;
+		int p = randomInt()%g.n;
 		int h = perm[i];
 		perm[i] = perm[p];
 		perm[p] = h;
@@ -294,16 +383,14 @@ void initializeColoringForTabu(Graph & g, int * c, int k)
 		for (int j=1; j<=k; j++) {
 			taken[j]=0;
 		}
-		for (int j=0; j<g.n; j++) {
-			numConfChecks++;
-			if (i!=j && g[i][j]) {
-				taken[c[j]]++;
-			}
+		numConfChecks += neighbors[i][0];
+		for (int j=1; j<=neighbors[i][0]; j++) {
+			taken[c[neighbors[i][j]]]++;
 		}
 		// if the currently assigned color is legal, leave it otherwise find a new legal color, and if not possible
 		// set it to a random color.
 		if (taken[c[i]]>0) {
-			int color= (rand()%k)+1;
+			int color= (randomInt()%k)+1;
 			for (int j=1; j<=k; j++) {
 				if (taken[j] == 0) {
 					color = j;
@@ -4,8 +4,8 @@
 #include "Graph.h"
 #include <vector>
 
-int generateInitialK(Graph &g, int alg, int *bestColouring);
-void initializeColoring(Graph & g, int * c, int k);
-void initializeColoringForTabu(Graph & g, int * c, int k);
+int generateInitialK(Graph &g, int alg, int *bestColouring, int **neighbors);
+void initializeColoring(Graph & g, int * c, int k, int ** neighbors);
+void initializeColoringForTabu(Graph & g, int * c, int k, int ** neighbors);
 
 #endif
@@ -3,14 +3,20 @@
 #include <iostream>
 #include <string.h>
 #include <stdlib.h>
+#include <sstream>
 
 using namespace std;
 
-void inputDimacsGraph(Graph & g, char * file)
+bool readDimacsGraph(Graph & g, const char * file, string & error)
 {
 	char c;
 	char str[400];
+	ostringstream err;
 	ifstream IN(file, ios::in);
+	if (IN.fail()) {
+		error = string("Cannot open graph file ") + file + "\n";
+		return false;
+	}
 	int line=0;
 	g.nbEdges=0;
 	int edges=-1;
@@ -26,10 +32,11 @@ void inputDimacsGraph(Graph & g, char * file)
 			IN.get(c);
 			IN.getline(str,39,' ');
 			if (strcmp(str,"edge") && strcmp(str,"edges")) {
-				cerr << "File " << file << " line " << line << ":\n";
-				cerr << "Error reading 'p' line: no 'edge' keyword found.\n";
-				cerr << "'" << str << "' found instead\n";
-				exit(-1);
+				err << "File " << file << " line " << line << ":\n";
+				err << "Error reading 'p' line: no 'edge' keyword found.\n";
+				err << "'" << str << "' found instead\n";
+				error = err.str();
+				return false;
 			}
 			IN >> g.n;
 			IN >> edges;
@@ -38,16 +45,18 @@ void inputDimacsGraph(Graph & g, char * file)
 			break;
 		case 'n':
 			if (blem) {
-				cerr << "File " << file << " line " << line << ":\n";
-				cerr << "Found 'n' line before a 'p' line.\n";
-				exit(-1);
+				err << "File " << file << " line " << line << ":\n";
+				err << "Found 'n' line before a 'p' line.\n";
+				error = err.str();
+				return false;
 			}
 			int node;
 			IN >> node;
 			if (node < 1 || node > g.n) {
-				cerr << "File " << file << " line " << line << ":\n";
-				cerr << "Node number " << node << " is out of range!\n";
-				exit(-1);
+				err << "File " << file << " line " << line << ":\n";
+				err << "Node number " << node << " is out of range!\n";
+				error = err.str();
+				return false;
 			}
 			node--;	
 			cout << "Tags (n Lines) not implemented in g object\n";
@@ -56,9 +65,10 @@ void inputDimacsGraph(Graph & g, char * file)
 			int node1, node2;
 			IN >> node1 >> node2;
 			if (node1 < 1 || node1 > g.n || node2 < 1 || node2 > g.n) {
-				cerr << "File " << file << " line " << line << ":\n";
-				cerr << "Node " << node1 << " or " << node2 << " is out of range!\n";
-				exit(-1);
+				err << "File " << file << " line " << line << ":\n";
+				err << "Node " << node1 << " or " << node2 << " is out of range!\n";
+				error = err.str();
+				return false;
 			}
 			node1--;
 			node2--;
@@ -95,9 +105,10 @@ void inputDimacsGraph(Graph & g, char * file)
 			IN.get(str,399,'\n');
 			break;
 		default:
-			cerr << "File " << file << " line " << line << ":\n";
-			cerr << "'" << c << "' is an unknown line code\n";
-			exit(-1);
+			err << "File " << file << " line " << line << ":\n";
+			err << "'" << c << "' is an unknown line code\n";
+			error = err.str();
+			return false;
 		}
 		IN.get(); // Kill the newline;
 	}
@@ -105,6 +116,32 @@ void inputDimacsGraph(Graph & g, char * file)
 	if (multiple) {
 		cerr << multiple << " multiple edges encountered\n";
 	}
+	return true;
+}
+
+void inputDimacsGraph(Graph & g, char * file)
+{
+	string error;
+	if (!readDimacsGraph(g, file, error)) {
+		cerr << error;
+		exit(-1);
+	}
+}
 
+unsigned long long hashGraphFile(const char * file, bool & ok)
+{
+	//64-bit FNV-1a of the bytes of the file
+	unsigned long long h = 0xcbf29ce484222325ULL;
+	char buf[65536];
+	ifstream IN(file, ios::in | ios::binary);
+	ok = !IN.fail();
+	while (ok && IN) {
+		IN.read(buf, sizeof(buf));
+		for (streamsize i = 0; i < IN.gcount(); i++) {
+			h ^= (unsigned char)buf[i];
+			h *= 0x100000001b3ULL;
+		}
+	}
+	return h;
 }
 
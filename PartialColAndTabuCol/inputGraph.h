@@ -2,7 +2,15 @@
 #define INPUTGRAPH_INCLUDED
 
 #include "Graph.h"
+#include <string>
 
 void inputDimacsGraph(Graph & g, char * filename);
 
+// As inputDimacsGraph(), but an unreadable or malformed file is reported in error (and false
+// returned) instead of ending the program
+bool readDimacsGraph(Graph & g, const char * filename, std::string & error);
+
+// Hash of the contents of a graph file, which identifies a graph independently of its path
+unsigned long long hashGraphFile(const char * filename, bool & ok);
+
 #endif
@@ -0,0 +1,18 @@
+#ifndef KBUCKETS_INCLUDED
+#define KBUCKETS_INCLUDED
+
+// The search kernels are instantiated for a few compile-time upper bounds on k. In the colour loop
+// "for (color = 1; color <= (KMax ? KMax : k); color++) { if (KMax && color > k) break; ... }"
+// the trip count is then a constant, so the loop can be fully unrolled for small k.
+// KMax = K_GENERIC gives the ordinary runtime loop.
+#define K_SMALL 16
+#define K_MEDIUM 64
+#define K_GENERIC 0
+
+#if defined(__GNUC__)
+#define UNROLL_COLOURS _Pragma("GCC unroll 16")
+#else
+#define UNROLL_COLOURS
+#endif
+
+#endif
@@ -0,0 +1,295 @@
+#include "kSearch.h"
+#include "reactcol.h"
+#include "tabu.h"
+#include "checkpoint.h"
+#include "reduce.h"
+#include "components.h"
+#include "workStealing.h"
+#include "rng.h"
+#include "solutionWriter.h"
+#include "threadLocal.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+using namespace std;
+
+extern THREAD_LOCAL unsigned long long numConfChecks;
+
+// Number of budget shares held back for the k just below the best colouring found while bracketing.
+// That k is the most uncertain one, so it gets whatever the (cheap) successful probes did not use.
+#define FRONTIER_SHARES 2
+
+static Deadline probeDeadline(KSearchParams &p, const Deadline &runDeadline, int shares)
+{
+	//The earliest of the run deadline, the per-k limit and, if shares > 0, an equal share of the time left
+	Deadline d = runDeadline;
+	double now = readClock(p.clockType);
+	if (p.kTimeLimit > 0 && (d.at == 0 || now + p.kTimeLimit < d.at)) d.at = now + p.kTimeLimit;
+	if (shares > 0 && runDeadline.at > 0) {
+		double share = now + (runDeadline.at - now) / shares;
+		if (share < d.at) d.at = share;
+	}
+	return d;
+}
+
+// Searches the components of the graph at k, one after the other or on p.componentPool, and
+// returns the sum of their costs. The components that can be coloured directly are not searched,
+// and each of the others gets a share of the checks left in proportion to its number of vertices.
+// Every search counts its checks and draws its random numbers on its own, from a seed drawn by the
+// caller in the order of the components, so the result does not depend on the number of threads.
+static long searchComponents(Components &comps, int *coloring, int k, unsigned long long limit, const Deadline &deadline, KSearchParams &p)
+{
+	vector<int> searched;
+	int searchedNodes = 0;
+	for (int c = 0; c < (int)comps.parts.size(); c++) {
+		if (comps.colourDirectly(c, k, coloring)) continue;
+		searched.push_back(c);
+		searchedNodes += comps.parts[c]->graph.n;
+	}
+	if (p.verbose >= 1) cout << comps.parts.size() << " components for k = " << k << ", " << comps.parts.size() - searched.size()
+		<< " coloured directly, " << searched.size() << " searched (" << searchedNodes << " vertices)" << endl;
+
+	int numSearched = (int)searched.size();
+	unsigned long long left = limit > numConfChecks ? limit - numConfChecks : 0;
+	vector<unsigned long long> seeds(numSearched), used(numSearched);
+	vector<long> costs(numSearched);
+	for (int i = 0; i < numSearched; i++) seeds[i] = randomInt();
+	ParallelScan *pool = p.componentPool == NULL ? p.pool : NULL;
+	auto search = [&](int i, int worker) {
+		Components::Part &part = *comps.parts[searched[i]];
+		unsigned long long share = (unsigned long long)((double)left * part.graph.n / searchedNodes);
+		unsigned long long checksBefore = numConfChecks, randomBefore = rngState;
+		numConfChecks = 0;
+		seedRandom(seeds[i]);
+		vector<int> partColoring(part.graph.n, 0);
+		if (p.algorithm == 1) costs[i] = reactcol(part.graph, &partColoring[0], k, share, p.tenure, 0, p.frequency, p.increment, part.neighbors, pool, NULL, NULL, deadline);
+		else costs[i] = tabu(part.graph, &partColoring[0], k, share, p.tenure, 0, p.frequency, p.increment, part.neighbors, pool, NULL, NULL, deadline);
+		if (costs[i] == 0) comps.merge(searched[i], &partColoring[0], coloring);
+		used[i] = numConfChecks;
+		numConfChecks = checksBefore;
+		rngState = randomBefore;
+	};
+	if (p.componentPool != NULL && numSearched > 1) p.componentPool->run(numSearched, search);
+	else for (int i = 0; i < numSearched; i++) search(i, 0);
+
+	long cost = 0;
+	for (int i = 0; i < numSearched; i++) {
+		numConfChecks += used[i];
+		cost += costs[i];
+	}
+	return cost;
+}
+
+static bool attemptK(Graph &g, int **neighbors, int *coloring, int *bestColouring, int k, unsigned long long limit, Deadline deadline,
+	KSearchParams &p, clock_t clockStart, ostream &confStream, ostream &timeStream)
+{
+	long cost;
+
+	//A resumed attempt keeps the limits it was given when it started
+	if (p.checkpoint != NULL) {
+		if (p.checkpoint->resuming) {
+			limit = p.checkpoint->run.probeLimit;
+			deadline = p.checkpoint->resumeDeadline(p.clockType);
+		}
+		else p.checkpoint->startAttempt(k, limit, deadline);
+	}
+
+	//With p.reduce the search is made on what is left of the graph for this k
+	Reduction *reduction = NULL;
+	Graph *sg = &g;
+	int **sNeighbors = neighbors;
+	if (p.reduce) {
+		reduction = new Reduction(g, neighbors, k);
+		if (p.verbose >= 1) cout << "Reduced to " << reduction->rest.n << " of " << g.n << " vertices for k = " << k << " (" << reduction->numLowDegree
+			<< " of degree < k, " << reduction->numDominated << " dominated)" << endl;
+		sg = &reduction->rest;
+		sNeighbors = reduction->neighbors;
+	}
+
+	//With p.components each connected component of that graph is searched on its own
+	Components *components = NULL;
+	if (p.components && sg->n > 0) {
+		components = new Components(*sg, sNeighbors);
+		if (components->parts.empty()) {
+			delete components;
+			components = NULL;
+		}
+	}
+
+	//Initialise the solution array
+	for (int i = 0; i < g.n; i++) coloring[i] = 0;
+
+	//Do the algorithm for this value of k, either until a slution is found, or limit is exceeded
+	if (sg->n == 0) cost = 0;
+	else if (components != NULL) cost = searchComponents(*components, coloring, k, limit, deadline, p);
+	else if (p.algorithm == 1) cost = reactcol(*sg, coloring, k, limit, p.tenure, p.verbose, p.frequency, p.increment, sNeighbors, p.pool, p.checkpoint, p.trace, deadline);
+	else cost = tabu(*sg, coloring, k, limit, p.tenure, p.verbose, p.frequency, p.increment, sNeighbors, p.pool, p.checkpoint, p.trace, deadline);
+	delete components;
+	if (reduction != NULL) {
+		if (cost == 0) reduction->restore(coloring);
+		delete reduction;
+	}
+
+	//Algorithm has finished at this k
+	int duration = int(((double)(clock() - clockStart) / CLOCKS_PER_SEC) * 1000);
+	int wallDuration = int((readClock(CLOCK_WALL) - p.wallStart) * 1000);
+	if (cost == 0) {
+		if (p.verbose >= 1) cout << setw(5) << k << setw(11) << duration << "ms\t" << numConfChecks << endl;
+		confStream << k << "\t" << numConfChecks << "\n";
+		timeStream << k << "\t" << duration << "\t" << wallDuration << "\n";
+		//Copy the current solution as the best solution
+		for (int i = 0; i < g.n; i++) bestColouring[i] = coloring[i] - 1;
+		if (p.solution != NULL) p.solution->submit(bestColouring, g.n);
+		return true;
+	}
+	if (p.verbose >= 1) {
+		if (!deadlinePassed(deadline)) cout << "\nRun limit exceeded.";
+		else cout << "\nTime limit exceeded.";
+		cout << " No solution using " << k << " colours was achieved (Checks = " << numConfChecks << ", " << duration << "ms)" << endl;
+	}
+	confStream << k << "\tX\t" << numConfChecks << "\n";
+	timeStream << k << "\tX\t" << duration << "\t" << wallDuration << "\n";
+	return false;
+}
+
+static int linearSearch(Graph &g, int **neighbors, int *coloring, int *bestColouring, int k, KSearchParams &p, clock_t clockStart,
+	const Deadline &runDeadline, ostream &confStream, ostream &timeStream, bool &miss, int &fail)
+{
+	bool failed = false;
+	//No colouring below the lower bound exists, so the descent ends there as at the target
+	int floor = p.targetCols > p.lowerBound ? p.targetCols : p.lowerBound;
+	k--;
+	if (p.checkpoint != NULL && p.checkpoint->resuming) k = p.checkpoint->run.probeK;
+	while (!failed && numConfChecks < p.maxChecks && !deadlinePassed(runDeadline) && k + 1 > floor) {
+		if (attemptK(g, neighbors, coloring, bestColouring, k, p.maxChecks, probeDeadline(p, runDeadline, 0), p, clockStart, confStream, timeStream)) {
+			//Check if the target or the lower bound has been met
+			if (k <= floor) {
+				if (p.verbose >= 1 && k > p.targetCols) cout << "\nSolution with " << k << " colours matches the lower bound. Ending..." << endl;
+				else if (p.verbose >= 1) cout << "\nSolution with <=" << k << " colours has been found. Ending..." << endl;
+				confStream << "1\t" << "X" << "\n";
+				timeStream << "1\t" << "X" << "\n";
+				break;
+			}
+		}
+		else {
+			//A k that could not be coloured within its limits ends the descent
+			miss = true;
+			fail++;
+			failed = true;
+		}
+		//Decrement k (if the run time hasn't been reached, we'll carry on with this new value)
+		k--;
+	}
+	return k;
+}
+
+static int ceilLog2(int x)
+{
+	int r = 0;
+	while ((1 << r) < x) r++;
+	return r;
+}
+
+static unsigned long long probeLimit(KSearchParams &p, int probesLeft)
+{
+	//Give the next probe an equal share of what is left, keeping FRONTIER_SHARES shares in reserve
+	unsigned long long remaining = p.maxChecks - numConfChecks;
+	return numConfChecks + remaining / (probesLeft + FRONTIER_SHARES);
+}
+
+static void markBracket(KSearchParams &p, int lo, int hi, int step, bool galloping)
+{
+	//Record the bracket in the checkpoint state, so that a resumed run continues with the same probes
+	if (p.checkpoint == NULL) return;
+	p.checkpoint->run.lo = lo;
+	p.checkpoint->run.hi = hi;
+	p.checkpoint->run.step = step;
+	p.checkpoint->run.galloping = galloping;
+}
+
+static int bracketSearch(Graph &g, int **neighbors, int *coloring, int *bestColouring, int k, KSearchParams &p, clock_t clockStart,
+	const Deadline &runDeadline, ostream &confStream, ostream &timeStream, bool &miss, int &fail)
+{
+	int floor = p.targetCols > p.lowerBound ? p.targetCols : p.lowerBound;
+	int hi = k;          // smallest k for which a colouring is known
+	int lo = floor - 1;  // largest k treated as unsolved (initially: not needed)
+	int step = 1, probe, probesLeft;
+	bool galloping = (p.strategy == KSEARCH_GALLOP);
+	int lastK = 0;       // last value of k attempted, and whether it failed
+	bool lastFailed = false;
+
+	if (p.checkpoint != NULL && p.checkpoint->resuming) {
+		//Go back to the bracket of the checkpoint; the loops below then pick the attempt that was running
+		lo = p.checkpoint->run.lo;
+		hi = p.checkpoint->run.hi;
+		step = p.checkpoint->run.step;
+		galloping = p.checkpoint->run.galloping != 0;
+	}
+
+	//Narrow the bracket (lo, hi] with probes that each get a fraction of the remaining checks and time
+	while (hi - lo > 1 && numConfChecks < p.maxChecks && !deadlinePassed(runDeadline)) {
+		if (galloping) {
+			probe = hi - step > lo + 1 ? hi - step : lo + 1;
+			probesLeft = ceilLog2(probe - lo) + 1;
+		}
+		else {
+			probe = lo + (hi - lo) / 2;
+			probesLeft = ceilLog2(hi - lo);
+		}
+		markBracket(p, lo, hi, step, galloping);
+		if (attemptK(g, neighbors, coloring, bestColouring, probe, probeLimit(p, probesLeft), probeDeadline(p, runDeadline, probesLeft + FRONTIER_SHARES),
+			p, clockStart, confStream, timeStream)) {
+			hi = probe;
+			step *= 2;
+			lastFailed = false;
+		}
+		else {
+			lo = probe;
+			galloping = false;
+			lastFailed = true;
+		}
+		lastK = probe;
+	}
+
+	//Spend everything that is left just below the best colouring, descending as in the linear search
+	int startK = k;
+	k = hi - 1;
+	while (numConfChecks < p.maxChecks && !deadlinePassed(runDeadline) && k >= floor) {
+		markBracket(p, lo, hi, step, galloping);
+		lastK = k;
+		lastFailed = !attemptK(g, neighbors, coloring, bestColouring, k, p.maxChecks, probeDeadline(p, runDeadline, 0), p, clockStart, confStream, timeStream);
+		if (lastFailed) break;
+		hi = k--;
+	}
+
+	//The value logged follows linearSearch(): the k that met the target or the lower bound, else
+	//one below the best k coloured, or two below it when the attempt just under it failed
+	if (hi <= floor && hi < startK) {
+		if (p.verbose >= 1 && hi > p.targetCols) cout << "\nSolution with " << hi << " colours matches the lower bound. Ending..." << endl;
+		else if (p.verbose >= 1) cout << "\nSolution with <=" << hi << " colours has been found. Ending..." << endl;
+		confStream << "1\t" << "X" << "\n";
+		timeStream << "1\t" << "X" << "\n";
+		return hi;
+	}
+	if (hi > floor) {
+		miss = true;
+		fail++;
+	}
+	return lastFailed && lastK == hi - 1 ? hi - 2 : hi - 1;
+}
+
+int kSearch(Graph &g, int **neighbors, int *coloring, int *bestColouring, int k, KSearchParams &p, clock_t clockStart,
+	ostream &confStream, ostream &timeStream, bool &miss, int &fail)
+{
+	//Try to find colourings with fewer than k colours, k being the number used by bestColouring.
+	//Returns the value of k reported in the results log.
+	Deadline runDeadline;
+	runDeadline.clockType = p.clockType;
+	runDeadline.at = 0;
+	if (p.timeLimit > 0) runDeadline.at = (p.clockType == CLOCK_CPU ? (double)clockStart / CLOCKS_PER_SEC : p.wallStart) + p.timeLimit;
+
+	if (p.strategy == KSEARCH_BISECTION || p.strategy == KSEARCH_GALLOP)
+		return bracketSearch(g, neighbors, coloring, bestColouring, k, p, clockStart, runDeadline, confStream, timeStream, miss, fail);
+	return linearSearch(g, neighbors, coloring, bestColouring, k, p, clockStart, runDeadline, confStream, timeStream, miss, fail);
+}
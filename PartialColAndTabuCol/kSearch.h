@@ -0,0 +1,51 @@
+#ifndef KSEARCH_INCLUDED
+#define KSEARCH_INCLUDED
+
+#include "Graph.h"
+#include "timeLimit.h"
+#include <ostream>
+#include <time.h>
+
+class ParallelScan;
+class Checkpointer;
+class Tracer;
+class WorkStealingPool;
+class SolutionWriter;
+
+// Strategies for choosing the values of k that are attempted below the constructive bound
+#define KSEARCH_LINEAR 1     // k, k-1, k-2, ... sharing one global budget (the original behaviour)
+#define KSEARCH_BISECTION 2  // bisection between the lower bound and the constructive bound
+#define KSEARCH_GALLOP 3     // k-1, k-2, k-4, k-8, ... then bisection inside the bracket
+
+struct KSearchParams {
+	int strategy;
+	int algorithm;
+	int tenure;
+	int verbose;
+	int frequency;
+	int increment;
+	int targetCols;
+	int lowerBound;
+	unsigned long long maxChecks;
+	int clockType;       // clock used for the time limits (CLOCK_WALL or CLOCK_CPU)
+	double timeLimit;    // seconds allowed for the whole run, 0 = no limit
+	double kTimeLimit;   // seconds allowed for each value of k, 0 = no limit
+	double wallStart;    // wall-clock time at which the run started
+	ParallelScan *pool;
+	Checkpointer *checkpoint;  // NULL = no checkpoints
+	Tracer *trace;             // NULL = no trajectory trace
+	SolutionWriter *solution;  // receives the colouring of each k coloured, NULL = not written
+	bool reduce;               // search each k on the graph left by Reduction (reduce.h); not with checkpoints
+	bool components;           // search the connected components separately (components.h); not with checkpoints
+	WorkStealingPool *componentPool;  // threads the components are searched on, NULL = one after the other
+};
+
+// Tries to colour the graph with fewer colours than bestColouring uses, with the strategy of
+// p.strategy. Returns the k written to the results log, which means the same for every strategy
+// (that of the original linear descent): the k that met the target or the lower bound if one did;
+// otherwise one below the best k coloured, or two below it if the run ended on a failed attempt
+// just under it.
+int kSearch(Graph &g, int **neighbors, int *coloring, int *bestColouring, int k, KSearchParams &p, clock_t clockStart,
+	std::ostream &confStream, std::ostream &timeStream, bool &miss, int &fail);
+
+#endif
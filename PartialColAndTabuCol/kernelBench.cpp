@@ -0,0 +1,312 @@
+/******************************************************************************/
+//  Microbenchmarks of the kernels of PartialColAndTabuCol, on random graphs generated in memory.
+//
+//  USAGE: kernelBench [--quick] [--time <seconds>] [--json <file>] [--baseline <file>] [--threshold <percent>]
+//
+//  Every kernel is repeated for at least --time seconds (the searches for twice as long) and the
+//  throughput is reported in operations per second and nanoseconds per operation, where an
+//  operation is a move, an iteration, a call, a colouring or a parsed edge (see the "unit" column).
+//  With --baseline, the results are compared with a JSON file written earlier by --json and the
+//  kernels that got slower by more than --threshold percent (DEFAULT = 10) are reported; the exit
+//  status is then 1.
+/******************************************************************************/
+
+#include "Graph.h"
+#include "inputGraph.h"
+#include "initializeColoring.h"
+#include "manipulateArrays.h"
+#include "checkCounter.h"
+#include "tabu.h"
+#include "reactcol.h"
+#include "timeLimit.h"
+#include "rng.h"
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace std;
+
+THREAD_LOCAL unsigned long long numConfChecks = 0;
+THREAD_LOCAL unsigned long long rngState = 1;
+
+struct BenchResult {
+	string name;
+	const char *unit;
+	unsigned long long ops;
+	double seconds;
+};
+
+static vector<BenchResult> results;
+
+static void report(const string &name, const char *unit, unsigned long long ops, double seconds)
+{
+	BenchResult r = { name, unit, ops, seconds };
+	results.push_back(r);
+	char rate[32];
+	snprintf(rate, sizeof(rate), "%s/s", unit);
+	printf("%-30s %14.0f %-12s %14.1f ns/%s\n", name.c_str(), ops / seconds, rate, seconds * 1e9 / ops, unit);
+	fflush(stdout);
+}
+
+// G(n,p) with the given density in percent
+static void randomGraph(Graph &g, int n, int density)
+{
+	g.resize(n);
+	unsigned long long state = 12345 + n * 100 + density;
+	long long threshold = (long long)density * (RANDOM_MAX + 1LL) / 100;
+	for (int i = 0; i < n; i++) {
+		for (int j = i + 1; j < n; j++) {
+			if (nextRandom(state) < threshold) {
+				g[i][j] = g[j][i] = 1;
+				g.nbEdges++;
+			}
+		}
+	}
+}
+
+static void freeAdjList(int **neighbors, int n)
+{
+	for (int i = 0; i < n; i++) delete[] neighbors[i];
+	delete[] neighbors;
+}
+
+// A list of random moves, so that the random numbers are not part of the timed loop
+struct MoveList {
+	vector<int> node, color;
+	MoveList(int n, int k) {
+		unsigned long long state = 99;
+		for (int i = 0; i < (1 << 16); i++) {
+			node.push_back(nextRandom(state) % n);
+			color.push_back(nextRandom(state) % k + 1);
+		}
+	}
+};
+
+static void benchParse(Graph &g, const string &tag, double minTime)
+{
+	//Write the graph in DIMACS format and read it back
+	const char *fileName = "kernelBench.tmp";
+	{
+		ofstream out(fileName);
+		out << "p edge " << g.n << " " << g.nbEdges << "\n";
+		for (int i = 0; i < g.n; i++)
+			for (int j = i + 1; j < g.n; j++)
+				if (g[i][j]) out << "e " << i + 1 << " " << j + 1 << "\n";
+	}
+	unsigned long long ops = 0;
+	double start = readClock(CLOCK_WALL), elapsed;
+	do {
+		Graph h;
+		inputDimacsGraph(h, (char *)fileName);
+		ops += h.nbEdges;
+	} while ((elapsed = readClock(CLOCK_WALL) - start) < minTime);
+	remove(fileName);
+	report("parse/" + tag, "edge", ops, elapsed);
+}
+
+static void benchDSatur(Graph &g, int **neighbors, const string &tag, double minTime, int &k)
+{
+	vector<int> colouring(g.n);
+	unsigned long long ops = 0;
+	seedRandom(1);
+	double start = readClock(CLOCK_WALL), elapsed;
+	do {
+		k = generateInitialK(g, 1, &colouring[0], neighbors);
+		ops++;
+	} while ((elapsed = readClock(CLOCK_WALL) - start) < minTime);
+	report("dsatur/" + tag, "colouring", ops, elapsed);
+}
+
+static void benchInitializeArrays(Graph &g, int **neighbors, int k, const string &tag, double minTime)
+{
+	int **nodesByColor, **conflicts, **tabuStatus, *nbcPosition;
+	vector<int> c(g.n);
+	seedRandom(1);
+	initializeColoring(g, &c[0], k, neighbors);
+	unsigned long long ops = 0;
+	double start = readClock(CLOCK_WALL), elapsed;
+	do {
+		initializeArrays(nodesByColor, conflicts, tabuStatus, nbcPosition, g, &c[0], k, neighbors);
+		freeArrays(nodesByColor, conflicts, tabuStatus, nbcPosition, k, g.n);
+		ops++;
+	} while ((elapsed = readClock(CLOCK_WALL) - start) < minTime);
+	report("initializeArrays/" + tag, "call", ops, elapsed);
+}
+
+static void benchMoves(Graph &g, int **neighbors, int k, const string &tag, double minTime)
+{
+	int **nodesByColor, **conflicts, **tabuStatus, *nbcPosition;
+	vector<int> c(g.n), nodesInConflict(g.n + 1), confPosition(g.n);
+	MoveList moves(g.n, k);
+	size_t mask = moves.node.size() - 1;
+
+	//PartialCol: an uncoloured node gets a colour, and its neighbours of that colour become uncoloured.
+	//At k below the DSatur bound there are always uncoloured nodes.
+	seedRandom(1);
+	initializeColoring(g, &c[0], k, neighbors);
+	initializeArrays(nodesByColor, conflicts, tabuStatus, nbcPosition, g, &c[0], k, neighbors);
+	long iteration = 0;
+	double start = readClock(CLOCK_WALL), elapsed;
+	do {
+		for (int i = 0; i < 4096 && nodesByColor[0][0] > 0; i++, iteration++) {
+			int node = nodesByColor[0][moves.node[iteration & mask] % nodesByColor[0][0] + 1];
+			moveNodeToColor<CheckCounter>(node, moves.color[iteration & mask], g, &c[0], nodesByColor, conflicts, nbcPosition, neighbors, tabuStatus, iteration, 10);
+		}
+	} while ((elapsed = readClock(CLOCK_WALL) - start) < minTime && nodesByColor[0][0] > 0);
+	freeArrays(nodesByColor, conflicts, tabuStatus, nbcPosition, k, g.n);
+	report("moveNodeToColor/" + tag, "move", iteration, elapsed);
+
+	//TabuCol: the list of nodes in conflict is kept up to date as well
+	seedRandom(1);
+	initializeColoringForTabu(g, &c[0], k, neighbors);
+	initializeArrays(nodesByColor, conflicts, tabuStatus, nbcPosition, g, &c[0], k, neighbors);
+	nodesInConflict[0] = 0;
+	for (int i = 0; i < g.n; i++)
+		if (conflicts[c[i]][i] > 0) nodesInConflict[(confPosition[i] = ++nodesInConflict[0])] = i;
+	iteration = 0;
+	start = readClock(CLOCK_WALL);
+	do {
+		for (int i = 0; i < 4096; i++, iteration++) {
+			int node = moves.node[iteration & mask], color = moves.color[iteration & mask];
+			if (color == c[node]) color = color % k + 1;
+			moveNodeToColorForTabu<CheckCounter>(node, color, g, &c[0], nodesByColor, conflicts, nbcPosition, neighbors,
+				&nodesInConflict[0], &confPosition[0], tabuStatus, iteration, 10);
+		}
+	} while ((elapsed = readClock(CLOCK_WALL) - start) < minTime);
+	freeArrays(nodesByColor, conflicts, tabuStatus, nbcPosition, k, g.n);
+	report("moveNodeToColorForTabu/" + tag, "move", iteration, elapsed);
+}
+
+// One call of tabu() or reactcol() at an infeasible k until the deadline, with verbose = 0 so that
+// the kernel timed is the one of normal runs
+static void benchSearch(Graph &g, int **neighbors, int k, bool tabuCol, const string &tag, double minTime)
+{
+	vector<int> c(g.n);
+	seedRandom(1);
+	numConfChecks = 0;
+	Deadline d;
+	d.clockType = CLOCK_WALL;
+	double start = readClock(CLOCK_WALL);
+	d.at = start + minTime;
+	if (tabuCol) tabu(g, &c[0], k, ~0ULL, 0, 0, 0, 0, neighbors, NULL, NULL, NULL, d);
+	else reactcol(g, &c[0], k, ~0ULL, 0, 0, 0, 0, neighbors, NULL, NULL, NULL, d);
+	double elapsed = readClock(CLOCK_WALL) - start;
+	unsigned long long iterations = searchIterations;
+	if (iterations > 0) report((tabuCol ? "tabu/" : "reactcol/") + tag, "iteration", iterations, elapsed);
+}
+
+static void writeJson(const char *fileName)
+{
+	ofstream out(fileName);
+	if (out.fail()) {
+		cerr << "ERROR OPENING output FILE " << fileName << endl;
+		exit(1);
+	}
+#ifdef THROUGHPUT_BUILD
+	const char *build = "throughput";
+#else
+	const char *build = "counting";
+#endif
+	//One result per line, which is what readBaseline() expects
+	out << "{\n  \"benchmark\": \"kernelBench\",\n  \"build\": \"" << build << "\",\n  \"results\": [\n";
+	char line[400];
+	for (size_t i = 0; i < results.size(); i++) {
+		const BenchResult &r = results[i];
+		snprintf(line, sizeof(line), "    {\"name\": \"%s\", \"unit\": \"%s\", \"ops\": %llu, \"seconds\": %.6f, \"opsPerSec\": %.1f, \"nsPerOp\": %.3f}%s\n",
+			r.name.c_str(), r.unit, r.ops, r.seconds, r.ops / r.seconds, r.seconds * 1e9 / r.ops, i + 1 < results.size() ? "," : "");
+		out << line;
+	}
+	out << "  ]\n}\n";
+}
+
+static map<string, double> readBaseline(const char *fileName)
+{
+	map<string, double> nsPerOp;
+	ifstream in(fileName);
+	if (in.fail()) {
+		cerr << "ERROR OPENING baseline FILE " << fileName << endl;
+		exit(1);
+	}
+	string line;
+	while (getline(in, line)) {
+		size_t name = line.find("\"name\": \""), ns = line.find("\"nsPerOp\": ");
+		if (name == string::npos || ns == string::npos) continue;
+		name += 9;
+		nsPerOp[line.substr(name, line.find('"', name) - name)] = atof(line.c_str() + ns + 11);
+	}
+	return nsPerOp;
+}
+
+static int compareWithBaseline(const char *fileName, double threshold)
+{
+	map<string, double> base = readBaseline(fileName);
+	int regressions = 0;
+	printf("\nComparison with %s (threshold %.1f%%):\n", fileName, threshold);
+	for (size_t i = 0; i < results.size(); i++) {
+		const BenchResult &r = results[i];
+		map<string, double>::iterator it = base.find(r.name);
+		if (it == base.end() || it->second <= 0) continue;
+		double ns = r.seconds * 1e9 / r.ops;
+		double change = 100.0 * (ns - it->second) / it->second;
+		bool regression = change > threshold;
+		if (regression) regressions++;
+		printf("%-30s %12.1f -> %12.1f ns/op %+7.1f%%%s\n", r.name.c_str(), it->second, ns, change, regression ? "  REGRESSION" : "");
+	}
+	printf("%d regression(s)\n", regressions);
+	return regressions;
+}
+
+int main(int argc, char **argv)
+{
+	double minTime = 0.5, threshold = 10;
+	bool quick = false;
+	const char *jsonFile = NULL, *baselineFile = NULL;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp("--quick", argv[i]) == 0) quick = true;
+		else if (strcmp("--time", argv[i]) == 0 && i + 1 < argc) minTime = atof(argv[++i]);
+		else if (strcmp("--json", argv[i]) == 0 && i + 1 < argc) jsonFile = argv[++i];
+		else if (strcmp("--baseline", argv[i]) == 0 && i + 1 < argc) baselineFile = argv[++i];
+		else if (strcmp("--threshold", argv[i]) == 0 && i + 1 < argc) threshold = atof(argv[++i]);
+		else {
+			cout << "USAGE: kernelBench [--quick] [--time <seconds>] [--json <file>] [--baseline <file>] [--threshold <percent>]\n";
+			exit(1);
+		}
+	}
+	if (quick && minTime == 0.5) minTime = 0.2;
+
+	//The densities of the experiments, at a few sizes (only 1000 nodes with --quick)
+	int sizes[] = { 500, 1000, 2000 };
+	int densities[] = { 10, 50, 90 };
+	for (int s = 0; s < 3; s++) {
+		if (quick && sizes[s] != 1000) continue;
+		for (int d = 0; d < 3; d++) {
+			Graph g;
+			randomGraph(g, sizes[s], densities[d]);
+			int **neighbors = new int *[g.n];
+			makeAdjList(neighbors, g);
+			char tag[32];
+			snprintf(tag, sizeof(tag), "%d-%d", sizes[s], densities[d]);
+
+			int k;
+			benchParse(g, tag, minTime);
+			benchDSatur(g, neighbors, tag, minTime, k);
+			//Well below the DSatur bound, so that the searches do not stop early
+			k = k * 4 / 5 > 2 ? k * 4 / 5 : 2;
+			benchInitializeArrays(g, neighbors, k, tag, minTime);
+			benchMoves(g, neighbors, k, tag, minTime);
+			benchSearch(g, neighbors, k, true, tag, 2 * minTime);
+			benchSearch(g, neighbors, k, false, tag, 2 * minTime);
+			freeAdjList(neighbors, g.n);
+		}
+	}
+
+	if (jsonFile != NULL) writeJson(jsonFile);
+	if (baselineFile != NULL && compareWithBaseline(baselineFile, threshold) > 0) return 1;
+	return 0;
+}
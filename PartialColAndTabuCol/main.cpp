@@ -20,6 +20,17 @@
 #include "tabu.h"
 #include "manipulateArrays.h"
 #include "initializeColoring.h"
+#include "parallelScan.h"
+#include "kSearch.h"
+#include "checkpoint.h"
+#include "trace.h"
+#include "batch.h"
+#include "daemon.h"
+#include "clique.h"
+#include "arena.h"
+#include "workStealing.h"
+#include "solutionWriter.h"
+#include "rng.h"
 #include <iomanip>
 #include <string.h>
 #include <iostream>
@@ -28,6 +39,8 @@
 #include <time.h>
 #include <limits.h>
 #include <string>
+#include <filesystem>
+#include <thread>
 
 //This makes sure the compiler uses _strtoui64(x, y, z) with Microsoft Compilers, otherwise strtoull(x, y, z) is used
 #ifdef _MSC_VER
@@ -36,7 +49,8 @@
 
 using namespace std;
 
-unsigned long long numConfChecks;
+THREAD_LOCAL unsigned long long numConfChecks;
+THREAD_LOCAL unsigned long long rngState = 1;
 
 void usage() {
 	cout<<"PartialCol and TabuCol Algorithm for Graph Colouring\n\n"
@@ -45,10 +59,31 @@ void usage() {
 		<<"-t              (If present, TabuCol is used. Else PartialCol is used.)\n"
 		<<"-tt             (If present, a dynamic tabu tenure is used (i.e. tabuTenure = (int)(0.6*nc) + rand(0,9)). Otherwise a reactive tenure is used).\n"
 		<<"-s <int>        (Stopping criteria expressed as number of constraint checks. Can be anything up to 9x10^18. DEFAULT = 100,000,000.)\n"
+		<<"--time-limit <sec>   (Stopping criteria expressed as seconds per run, checked alongside -s. DEFAULT = no limit.)\n"
+		<<"--k-time-limit <sec> (Seconds allowed for each value of k. DEFAULT = no limit.)\n"
+		<<"--cpu-time      (If present, time limits are measured in CPU time. Otherwise wall-clock time is used.)\n"
 		<<"-r <int>        (Random seed. DEFAULT = 1)\n"
 		<<"-T <int>        (Target number of colours. Algorithm halts if this is reached. DEFAULT = 1.)\n"
 		<<"-v              (Verbosity. If present, output is sent to screen. If -v is repeated, more output is given.)\n"
-		<<"-a <int>        (Choice of construction algorithm to determine initial value for k. DSsatur = 1, Greedy = 2. DEFAULT = 1.)\n"
+		<<"-a <int>        (Choice of construction algorithm to determine initial value for k. DSsatur = 1, Greedy = 2, RLF = 3. DEFAULT = 1.)\n"
+		<<"--k-search <int> (Strategy for the values of k attempted. Linear descent = 1, Bisection = 2, Galloping = 3. DEFAULT = 1.)\n"
+		<<"--lower-bound <int> (A known lower bound on the number of colours. The search stops when a colouring with this many colours is found. DEFAULT = 1.)\n"
+		<<"--clique <int>  (Raise the lower bound to the size of a clique. None = 0, Greedy from every vertex on all cores = 1, Exact for small graphs = 2. DEFAULT = 1.)\n"
+		<<"--reduce        (If present, the vertices of degree < k and the dominated vertices are taken out before each k and coloured after the search. Not with --checkpoint.)\n"
+		<<"--components    (If present, the connected components of the graph are searched separately at each k, on --workers threads. Not with --checkpoint.)\n"
+		<<"--huge-pages <int> (Pages of the search arrays. Normal = 0, Transparent huge pages = 1, Explicit huge pages (MAP_HUGETLB) falling back to transparent = 2. Linux only. DEFAULT = 0.)\n"
+		<<"--threads <int> (Number of threads used to evaluate the moves of one iteration. DEFAULT = 1.)\n"
+		<<"--par-threshold <int> (Threads are only used when (nodes in conflict) x k is at least this. DEFAULT = 100,000.)\n"
+		<<"--checkpoint <sec>  (Write the state of the search to a checkpoint file every <sec> seconds of wall-clock time. DEFAULT = no checkpoints.)\n"
+		<<"--checkpoint-file <file> (Name of the checkpoint file. DEFAULT = checkpoint.bin.)\n"
+		<<"--resume        (Continue the run saved in the checkpoint file. Use the same graph and options as the interrupted run.)\n"
+		<<"--trace <file>  (Record the moves of the search in a binary trace file, see traceToCsv. DEFAULT = no trace.)\n"
+		<<"--trace-every <int> (Record only every <int>th iteration. DEFAULT = 1.)\n"
+		<<"--batch <file>  (Solve the jobs listed in <file>, one graph and its options per line, in this process. See batch.h.)\n"
+		<<"--workers <int> (Number of batch jobs, or of components with --components, solved at the same time. DEFAULT = number of cores.)\n"
+		<<"--out-dir <dir> (Directory for the solution and results log of every batch job. DEFAULT = batch.)\n"
+		<<"--daemon <socket> (Stay running and solve the requests sent to the Unix socket <socket>, see solveClient. --workers requests are solved at the same time.)\n"
+		<<"--cache <int>   (Number of graphs the daemon keeps in memory. DEFAULT = 8.)\n"
 		<<"****\n";
 	exit(1);
 }
@@ -61,7 +96,17 @@ int main(int argc, char ** argv)
 
 	Graph g;
 	bool miss=false;
-	int k, frequency = 0, increment = 0, verbose = 0, randomSeed = 1, tenure = 0, algorithm = 1, cost, duration, constructiveAlg = 1, targetCols = 1, fail=0;
+	int k = 0, frequency = 0, increment = 0, verbose = 0, randomSeed = 1, tenure = 0, algorithm = 1, duration, constructiveAlg = 1, targetCols = 1, fail=0;
+	int numThreads = 1, kStrategy = KSEARCH_LINEAR, lowerBound = 1, clockType = CLOCK_WALL, cliqueMode = CLIQUE_GREEDY;
+	double timeLimit = 0, kTimeLimit = 0, checkpointInterval = 0;
+	string checkpointFile = "checkpoint.bin";
+	bool resume = false, reduce = false, components = false;
+	string traceFile;
+	unsigned long long traceEvery = 1;
+	const char *batchFile = NULL, *outDir = "batch", *daemonSocket = NULL;
+	int cacheSize = 8;
+	int numWorkers = thread::hardware_concurrency();
+	long long parThreshold = 100000;
 	unsigned long long maxChecks = INT_MAX;
 	// INT_MAX
 	// 800000000
@@ -89,17 +134,159 @@ int main(int argc, char ** argv)
 		else if (strcmp("-T", argv[i]) == 0) {
 			targetCols = atoi(argv[++i]);
 		}
+		else if (strcmp("--time-limit", argv[i]) == 0) {
+			timeLimit = atof(argv[++i]);
+		}
+		else if (strcmp("--k-time-limit", argv[i]) == 0) {
+			kTimeLimit = atof(argv[++i]);
+		}
+		else if (strcmp("--cpu-time", argv[i]) == 0) {
+			clockType = CLOCK_CPU;
+		}
+		else if (strcmp("--k-search", argv[i]) == 0) {
+			kStrategy = atoi(argv[++i]);
+		}
+		else if (strcmp("--lower-bound", argv[i]) == 0) {
+			lowerBound = atoi(argv[++i]);
+		}
+		else if (strcmp("--reduce", argv[i]) == 0) {
+			reduce = true;
+		}
+		else if (strcmp("--components", argv[i]) == 0) {
+			components = true;
+		}
+		else if (strcmp("--clique", argv[i]) == 0) {
+			cliqueMode = atoi(argv[++i]);
+		}
+		else if (strcmp("--huge-pages", argv[i]) == 0) {
+			setHugePages(atoi(argv[++i]));
+		}
+		else if (strcmp("--threads", argv[i]) == 0) {
+			numThreads = atoi(argv[++i]);
+		}
+		else if (strcmp("--par-threshold", argv[i]) == 0) {
+			parThreshold = strtoull(argv[++i], NULL, 10);
+		}
+		else if (strcmp("--checkpoint", argv[i]) == 0) {
+			checkpointInterval = atof(argv[++i]);
+		}
+		else if (strcmp("--checkpoint-file", argv[i]) == 0) {
+			checkpointFile = argv[++i];
+		}
+		else if (strcmp("--resume", argv[i]) == 0) {
+			resume = true;
+		}
+		else if (strcmp("--trace", argv[i]) == 0) {
+			traceFile = argv[++i];
+		}
+		else if (strcmp("--trace-every", argv[i]) == 0) {
+			traceEvery = strtoull(argv[++i], NULL, 10);
+		}
+		else if (strcmp("--batch", argv[i]) == 0) {
+			batchFile = argv[++i];
+		}
+		else if (strcmp("--workers", argv[i]) == 0) {
+			numWorkers = atoi(argv[++i]);
+		}
+		else if (strcmp("--out-dir", argv[i]) == 0) {
+			outDir = argv[++i];
+		}
+		else if (strcmp("--daemon", argv[i]) == 0) {
+			daemonSocket = argv[++i];
+		}
+		else if (strcmp("--cache", argv[i]) == 0) {
+			cacheSize = atoi(argv[++i]);
+		}
 		else {
 			cout << "PartialCol/TabuCol Algorithm using <" << argv[i] << ">\n\n";
 			inputDimacsGraph(g, argv[i]);
 		}
 	}
 
+	//In batch mode every job has its own graph and options
+	if (batchFile != NULL) return runBatch(batchFile, outDir, numWorkers < 1 ? 1 : numWorkers, verbose) == 0 ? 0 : 1;
+	//...and so has every request sent to the daemon
+	if (daemonSocket != NULL) return runDaemon(daemonSocket, numWorkers, cacheSize, verbose);
+
 	if (targetCols < 2 || targetCols > g.n) targetCols = 2;
 
+	//A clique needs as many colours as it has nodes, so once a colouring with that many is found,
+	//attempting fewer colours can only waste the budget
+	if (cliqueMode != CLIQUE_NONE && g.n > 0) {
+		int **cliqueNeighbors = new int*[g.n];
+		makeAdjList(cliqueNeighbors, g);
+		double cliqueStart = readClock(CLOCK_WALL);
+		bool proven;
+		int clique = cliqueBound(g, cliqueNeighbors, cliqueMode, thread::hardware_concurrency(), proven);
+		if (verbose >= 1) cout << "Clique of " << clique << " nodes found" << (proven ? " (maximum)" : "") << " in " << int((readClock(CLOCK_WALL) - cliqueStart) * 1000) << "ms" << endl;
+		if (clique > lowerBound) lowerBound = clique;
+		for (int i = 0; i < g.n; i++) delete[] cliqueNeighbors[i];
+		delete[] cliqueNeighbors;
+	}
+
 	//This variable keeps count of the number of times information about the instance is looked up 
 	numConfChecks = 0;
 
+	//The worker pool for the move evaluation is created once and kept for all runs (NULL = single thread)
+	ParallelScan *pool = NULL;
+	if (numThreads > 1) pool = new ParallelScan(numThreads, parThreshold);
+
+	//Settings for the search over k
+	KSearchParams searchParams;
+	searchParams.strategy = kStrategy;
+	searchParams.algorithm = algorithm;
+	searchParams.tenure = tenure;
+	searchParams.verbose = verbose;
+	searchParams.frequency = frequency;
+	searchParams.increment = increment;
+	searchParams.targetCols = targetCols;
+	searchParams.lowerBound = lowerBound;
+	searchParams.maxChecks = maxChecks;
+	searchParams.clockType = clockType;
+	searchParams.timeLimit = timeLimit;
+	searchParams.kTimeLimit = kTimeLimit;
+	searchParams.pool = pool;
+	searchParams.solution = new SolutionWriter("solution.txt");
+	searchParams.reduce = reduce;
+	searchParams.components = components;
+	searchParams.componentPool = components && numWorkers > 1 ? new WorkStealingPool(numWorkers) : NULL;
+
+	//Checkpoints are written every checkpointInterval seconds; with --resume the run starts from the last one
+	Checkpointer *ckpt = NULL;
+	int firstSeed = randomSeed;
+	if (checkpointInterval > 0 || resume) {
+		//A checkpoint holds the arrays of the whole graph
+		if (reduce) { cout << "ERROR: --reduce cannot be used with --checkpoint or --resume" << endl; exit(1); }
+		if (components) { cout << "ERROR: --components cannot be used with --checkpoint or --resume" << endl; exit(1); }
+		ckpt = new Checkpointer(checkpointFile, checkpointInterval);
+		ckpt->run.n = g.n;
+		ckpt->run.nbEdges = g.nbEdges;
+		ckpt->run.algorithm = algorithm;
+		ckpt->run.tenure = tenure;
+		ckpt->run.strategy = kStrategy;
+		ckpt->run.randomSeed = randomSeed;
+		ckpt->pool = pool;
+		ckpt->solution = searchParams.solution;
+		if (resume) {
+			string error;
+			if (!ckpt->load(error)) { cout << "ERROR: cannot resume, " << error << endl; exit(1); }
+			firstSeed = randomSeed + ckpt->run.run;
+			fail = ckpt->run.fail;
+			miss = ckpt->run.miss != 0;
+			//The best colouring of the earlier seeds, so that a worse one of this seed is not written
+			if (!ckpt->solutionColouring.empty()) searchParams.solution->submit(&ckpt->solutionColouring[0], g.n);
+		}
+	}
+	searchParams.checkpoint = ckpt;
+
+	//The trajectory trace, written by a background thread while the search runs
+	Tracer *trace = NULL;
+	if (!traceFile.empty()) {
+		trace = new Tracer(traceFile, traceEvery);
+		if (trace->fail()) { cout << "ERROR OPENING trace FILE";exit(1); }
+	}
+	searchParams.trace = trace;
+
 
 	/////////////////////////// Uncomment this if you remove for-loop ///////////////////////////////////////
 	//numConfChecks = 0;
@@ -136,7 +323,7 @@ int main(int argc, char ** argv)
 	//clock_t clockStart = clock();
 
 	////Generate the initial value for k using greedy or dsatur algorithm
-	//k = generateInitialK(g, constructiveAlg, bestColouring);
+	//k = generateInitialK(g, constructiveAlg, bestColouring, neighbors);
 	////..and write the results to the output file
 	//duration = int(((double)(clock() - clockStart) / CLOCKS_PER_SEC) * 1000);
 	//if (verbose >= 1) cout << setw(5) << k << setw(11) << duration << "ms\t" << numConfChecks << " (via constructive)" << endl;
@@ -151,8 +338,8 @@ int main(int argc, char ** argv)
 	//	for (int i = 0; i < g.n; i++) coloring[i] = 0;
 
 	//	//Do the algorithm for this value of k, either until a slution is found, or maxChecks is exceeded
-	//	if (algorithm == 1) cost = reactcol(g, coloring, k, maxChecks, tenure, verbose, frequency, increment, neighbors);
-	//	else cost = tabu(g, coloring, k, maxChecks, tenure, verbose, frequency, increment, neighbors);
+	//	if (algorithm == 1) cost = reactcol(g, coloring, k, maxChecks, tenure, verbose, frequency, increment, neighbors, pool);
+	//	else cost = tabu(g, coloring, k, maxChecks, tenure, verbose, frequency, increment, neighbors, pool);
 
 	//	//Algorithm has finished at this k
 	//	duration = int(((double)(clock() - clockStart) / CLOCKS_PER_SEC) * 1000);
@@ -183,14 +370,27 @@ int main(int argc, char ** argv)
 	//}
 
 	// Run 5 times on 5 different seeds, comment out this for loop if only 1 run is needed
-	for (int i = randomSeed; i < randomSeed + 5; i++) {
-		numConfChecks = 0;
+	for (int i = firstSeed; i < randomSeed + 5; i++) {
+		bool resumeRun = ckpt != NULL && ckpt->resuming;
+		if (!resumeRun) {
+			numConfChecks = 0;
 
-		srand(randomSeed+rand()%100);
+			seedRandom(randomSeed+randomInt()%100);
+		}
 
 		//Now set up some output files
 		ofstream timeStream, confStream;
-		timeStream.open("teffort.txt"); confStream.open("ceffort.txt");
+		if (resumeRun) {
+			//Drop the lines written after the checkpoint and carry on from there
+			error_code ec1, ec2;
+			filesystem::resize_file("teffort.txt", ckpt->run.timePos, ec1);
+			filesystem::resize_file("ceffort.txt", ckpt->run.confPos, ec2);
+			if (ec1 || ec2) { cout << "ERROR: cannot resume, teffort.txt or ceffort.txt is missing" << endl; exit(1); }
+			timeStream.open("teffort.txt", ios::app); confStream.open("ceffort.txt", ios::app);
+		}
+		else {
+			timeStream.open("teffort.txt"); confStream.open("ceffort.txt");
+		}
 		if (timeStream.fail() || confStream.fail()) { cout << "ERROR OPENING output FILE";exit(1); }
 
 		//Do a check to see if we have the empty graph. If so, end immediately.
@@ -216,60 +416,48 @@ int main(int argc, char ** argv)
 
 		//Now start the timer
 		clock_t clockStart = clock();
-
-		//Generate the initial value for k using greedy or dsatur algorithm
-		k = generateInitialK(g, constructiveAlg, bestColouring);
-		//..and write the results to the output file
-		duration = int(((double)(clock() - clockStart) / CLOCKS_PER_SEC) * 1000);
-		if (verbose >= 1) cout << setw(5) << k << setw(11) << duration << "ms\t" << numConfChecks << " (via constructive)" << endl;
-		confStream << k << "\t" << numConfChecks << "\n";
-		timeStream << k << "\t" << duration << "\n";
-
-		//MAIN ALGORITHM
-		k--;
-		while (numConfChecks < maxChecks && k + 1 > targetCols) {
-
-			//Initialise the solution array
-			for (int i = 0; i < g.n; i++) coloring[i] = 0;
-
-			//Do the algorithm for this value of k, either until a slution is found, or maxChecks is exceeded
-			if (algorithm == 1) cost = reactcol(g, coloring, k, maxChecks, tenure, verbose, frequency, increment, neighbors);
-			else cost = tabu(g, coloring, k, maxChecks, tenure, verbose, frequency, increment, neighbors);
-
-			//Algorithm has finished at this k
+		searchParams.wallStart = readClock(CLOCK_WALL);
+
+		if (resumeRun) {
+			//Continue the clocks, counters and random numbers of the interrupted run
+			clockStart -= (clock_t)(ckpt->run.cpuElapsed * CLOCKS_PER_SEC);
+			searchParams.wallStart -= ckpt->run.wallElapsed;
+			numConfChecks = ckpt->run.checks;
+			rngState = ckpt->run.random;
+			if (pool != NULL && pool->sliceRandomState().size() == ckpt->sliceRandom.size()) pool->sliceRandomState() = ckpt->sliceRandom;
+			else if (pool != NULL || !ckpt->sliceRandom.empty()) cout << "WARNING: --threads differs from the interrupted run, the search will not repeat it exactly" << endl;
+			for (int j = 0; j < g.n; j++) bestColouring[j] = ckpt->bestColouring[j];
+			k = ckpt->run.startK;
+			if (verbose >= 1) cout << "Resuming seed " << i << " at k = " << ckpt->run.probeK << " (Checks = " << numConfChecks << ")" << endl;
+		}
+		else {
+			//Generate the initial value for k using greedy or dsatur algorithm
+			k = generateInitialK(g, constructiveAlg, bestColouring, neighbors);
+			//..and write the results to the output file
 			duration = int(((double)(clock() - clockStart) / CLOCKS_PER_SEC) * 1000);
-			if (cost == 0) {
-				if (verbose >= 1) cout << setw(5) << k << setw(11) << duration << "ms\t" << numConfChecks << endl;
-				confStream << k << "\t" << numConfChecks << "\n";
-				timeStream << k << "\t" << duration << "\n";
-				//Copy the current solution as the best solution
-				for (int i = 0; i < g.n; i++) bestColouring[i] = coloring[i] - 1;
-				//Check if the target has been met
-				if (k <= targetCols) {
-					if (verbose >= 1) cout << "\nSolution with <=" << k << " colours has been found. Ending..." << endl;
-					confStream << "1\t" << "X" << "\n";
-					timeStream << "1\t" << "X" << "\n";
-					break;
-				}
-			}
-			else {
-				if (verbose >= 1) cout << "\nRun limit exceeded. No solution using " << k << " colours was achieved (Checks = " << numConfChecks << ", " << duration << "ms)" << endl;
-				confStream << k << "\tX\t" << numConfChecks << "\n";
-				timeStream << k << "\tX\t" << duration << "\n";
-				miss = true;
-				fail++;
-
-			}
-			//Decrement k (if the run time hasn't been reached, we'll carry on with this new value)
-			k--;
-			//output the solution to a text file
-			ofstream solStrm;
-			solStrm.open("solution.txt");
-			solStrm << g.n << "\n";
-			for (int i = 0;i < g.n;i++) solStrm << i + 1 << ' ' << bestColouring[i] << "\n";
-			solStrm.close();
+			if (verbose >= 1) cout << setw(5) << k << setw(11) << duration << "ms\t" << numConfChecks << " (via constructive)" << endl;
+			confStream << k << "\t" << numConfChecks << "\n";
+			timeStream << k << "\t" << duration << "\t" << int((readClock(CLOCK_WALL) - searchParams.wallStart) * 1000) << "\n";
+		}
+		//Written unless an earlier run has done better
+		searchParams.solution->submit(bestColouring, g.n);
+
+		if (trace != NULL) trace->run = i - randomSeed;
+		if (ckpt != NULL) {
+			//What a checkpoint of this run needs besides the state of the search
+			ckpt->run.run = i - randomSeed;
+			ckpt->run.fail = fail;
+			ckpt->run.miss = miss;
+			ckpt->run.startK = k;
+			ckpt->bestColouringNow = bestColouring;
+			ckpt->clockStart = clockStart;
+			ckpt->wallStart = searchParams.wallStart;
+			ckpt->confStream = &confStream;
+			ckpt->timeStream = &timeStream;
 		}
 
+		//MAIN ALGORITHM
+		k = kSearch(g, neighbors, coloring, bestColouring, k, searchParams, clockStart, confStream, timeStream, miss, fail);
 	}
 
 	//output the solution to a text file
@@ -284,25 +472,39 @@ int main(int argc, char ** argv)
 	ofstream resultsLog("resultsLog.log", ios::app);
 	if (miss==false || fail<5) {
 		if ((tenure == 1) && (algorithm == 1))
-			resultsLog << "partialcol " << "targetK " << targetCols << " dynamic " << k << " HIT " << 5-fail << endl;
+			resultsLog << "partialcol " << "targetK " << targetCols << " dynamic " << k << " HIT " << 5-fail << " LB " << lowerBound << endl;
 		if ((tenure == 1) && (algorithm == 2))
-			resultsLog << "tabucol " << "targetK " << targetCols << " dynamic " << k << " HIT " << 5 - fail << endl;
+			resultsLog << "tabucol " << "targetK " << targetCols << " dynamic " << k << " HIT " << 5 - fail << " LB " << lowerBound << endl;
 		if ((tenure == 0) && (algorithm == 1))
-			resultsLog << "partialcol " << "targetK " << targetCols << " reactive " << k << " HIT " << 5 - fail <<endl;
+			resultsLog << "partialcol " << "targetK " << targetCols << " reactive " << k << " HIT " << 5 - fail << " LB " << lowerBound << endl;
 		if ((tenure == 0) && (algorithm == 2))
-			resultsLog << "tabucol " << "targetK " << targetCols << " reactive " << k << " HIT " << 5 - fail << endl;
+			resultsLog << "tabucol " << "targetK " << targetCols << " reactive " << k << " HIT " << 5 - fail << " LB " << lowerBound << endl;
 	}
 	else {
 		if ((tenure == 1) && (algorithm == 1))
-			resultsLog << "partialcol " << "targetK " << targetCols << " dynamic " << k << " MiSS " << 5 - fail << endl;
+			resultsLog << "partialcol " << "targetK " << targetCols << " dynamic " << k << " MISS " << 5 - fail << " LB " << lowerBound << endl;
 		if ((tenure == 1) && (algorithm == 2))
-			resultsLog << "tabucol " << "targetK " << targetCols << " dynamic " << k << " MiSS " << 5 - fail << endl;
+			resultsLog << "tabucol " << "targetK " << targetCols << " dynamic " << k << " MISS " << 5 - fail << " LB " << lowerBound << endl;
 		if ((tenure == 0) && (algorithm == 1))
-			resultsLog << "partialcol " << "targetK " << targetCols << " reactive " << k << " MiSS " << 5 - fail << endl;
+			resultsLog << "partialcol " << "targetK " << targetCols << " reactive " << k << " MISS " << 5 - fail << " LB " << lowerBound << endl;
 		if ((tenure == 0) && (algorithm == 2))
-			resultsLog << "tabucol " << "targetK " << targetCols << " reactive " << k << " MISS " << 5 - fail << endl;
+			resultsLog << "tabucol " << "targetK " << targetCols << " reactive " << k << " MISS " << 5 - fail << " LB " << lowerBound << endl;
 	}
 	resultsLog.close();
+	if (verbose >= 1) {
+		cout << "Peak resident memory: " << fixed << setprecision(1) << peakResidentMB() << " MB";
+		if (arrayPages() >= 0) cout << " (search arrays on " << hugePagesName(arrayPages()) << ")";
+		cout << endl;
+	}
+	delete trace;
+	if (ckpt != NULL) {
+		//All runs have finished, so there is nothing left to resume
+		ckpt->finish();
+		delete ckpt;
+	}
+	delete pool;
+	delete searchParams.componentPool;
+	delete searchParams.solution;
 	
 
 	/////////////////////////// Uncomment this if you remove for-loop ///////////////////////////////////////
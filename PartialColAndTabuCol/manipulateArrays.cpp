@@ -1,7 +1,11 @@
 #include "manipulateArrays.h"
+#include "checkCounter.h"
+#include "threadLocal.h"
+#include "arena.h"
 #include <iostream>
+#include <algorithm>
 
-extern unsigned long long numConfChecks;
+using namespace std;
 
 void makeAdjList(int **neighbors, Graph &g)
 {
@@ -19,32 +23,56 @@ void makeAdjList(int **neighbors, Graph &g)
 	}
 }
 
-void initializeArrays(int ** & nodesByColor, int ** & conflicts, int ** & tabuStatus, int * & nbcPosition,	Graph & g, int * c, int k)
+// The arrays of a search are cut out of one block of memory, the arena, kept by the thread that
+// used it and handed out again to its next search, so that a batch of small instances (or the many
+// values of k of one run) does not allocate them again every time. The arena only grows; it can be
+// backed by huge pages (see setHugePages()), which spares TLB misses on the conflicts and tabuStatus
+// tables of large graphs.
+struct SearchArena {
+	char *base;
+	size_t size;
+	int mode;
+};
+
+static THREAD_LOCAL SearchArena arena;
+
+// Bytes of the arena from offset on, for count elements of size elementSize, starting on a cache line
+static size_t carve(size_t &offset, size_t count, size_t elementSize)
 {
-	int n=g.n;
-	// Allocate and initialize (k+1)x(n+1) array for nodesByColor and conflicts
-	nodesByColor = new int*[k+1];
-	conflicts = new int*[k+1];
-	for (int i=0; i<=k; i++) {
-		nodesByColor[i] = new int[n+1];
-		nodesByColor[i][0] = 0;
-		conflicts[i] = new int[n+1];
-		for (int j=0; j<=n; j++) {
-			conflicts[i][j]=0;
-		}
-	}
+	size_t start = (offset + 63) & ~(size_t)63;
+	offset = start + count * elementSize;
+	return start;
+}
 
-	// Allocate the tabuStatus array
-	tabuStatus = new int*[n];
-	for (int i=0; i<n; i++) {
-		tabuStatus[i]= new int[k+1];
-		for (int j=0; j<=k; j++) {
-			tabuStatus[i][j] = 0;
-		}
-	}
+static int **cutRows(char *base, size_t rowsAt, size_t blockAt, int numRows, int rowSize)
+{
+	int **rows = (int **)(base + rowsAt);
+	int *block = (int *)(base + blockAt);
+	for (int i=0; i<numRows; i++) rows[i] = block + (size_t)i * rowSize;
+	return rows;
+}
 
-	// Allocate the nbcPositions array
-	nbcPosition = new int[n];
+void initializeArrays(int ** & nodesByColor, int ** & conflicts, int ** & tabuStatus, int * & nbcPosition,	Graph & g, int * c, int k, int ** neighbors)
+{
+	int n=g.n;
+	// (k+1)x(n+1) arrays for nodesByColor and conflicts, nx(k+1) for tabuStatus, and nbcPosition
+	size_t size = 0;
+	size_t nbcRows = carve(size, k+1, sizeof(int *)), nbcBlock = carve(size, (size_t)(k+1)*(n+1), sizeof(int));
+	size_t confRows = carve(size, k+1, sizeof(int *)), confBlock = carve(size, (size_t)(k+1)*(n+1), sizeof(int));
+	size_t tabuRows = carve(size, n, sizeof(int *)), tabuBlock = carve(size, (size_t)n*(k+1), sizeof(int));
+	size_t position = carve(size, n, sizeof(int));
+	if (arena.size < size) {
+		freeArena(arena.base, arena.size, arena.mode);
+		arena.base = allocateArena(size, arena.mode);
+		arena.size = size;
+	}
+	nodesByColor = cutRows(arena.base, nbcRows, nbcBlock, k+1, n+1);
+	conflicts = cutRows(arena.base, confRows, confBlock, k+1, n+1);
+	tabuStatus = cutRows(arena.base, tabuRows, tabuBlock, n, k+1);
+	nbcPosition = (int *)(arena.base + position);
+	for (int i=0; i<=k; i++) nodesByColor[i][0] = 0;
+	fill(conflicts[0], conflicts[0] + (size_t)(k+1)*(n+1), 0);
+	fill(tabuStatus[0], tabuStatus[0] + (size_t)n*(k+1), 0);
 
 	// Initialize the nodesByColor and nbcPosition array
 	for (int i=0; i<n; i++) {
@@ -52,18 +80,17 @@ void initializeArrays(int ** & nodesByColor, int ** & conflicts, int ** & tabuSt
 		nodesByColor[ c[i] ][ (nbcPosition[i] = ++nodesByColor[c[i]][0]) ] = i;
 	}
 
-	// Initialize the conflicts and neighbors array
+	// Initialize the conflicts array from the adjacency lists, one check per neighbour looked up
 	for (int i=0; i<n; i++) {
-		for (int j=0; j<n; j++) {
-			numConfChecks++;
-			if (g[i][j] && i!=j) {
-				conflicts[ c[j] ][ i ]++;
-			}
+		numConfChecks += neighbors[i][0];
+		for (int j=1; j<=neighbors[i][0]; j++) {
+			conflicts[ c[neighbors[i][j]] ][ i ]++;
 		}
 	}
 
 }
 
+template<class Counter>
 void moveNodeToColor(int bestNode, int bestColor, Graph & g, int * c, int ** nodesByColor, int ** conflicts, int * nbcPosition, int ** neighbors, int ** tabuStatus,  long totalIterations, int tabuTenure) {
 	
 	// move bestNodes to bestColor
@@ -77,10 +104,11 @@ void moveNodeToColor(int bestNode, int bestColor, Graph & g, int * c, int ** nod
 	nodesByColor[bestColor][ (nbcPosition[bestNode]=++nodesByColor[bestColor][0]) ] = bestNode;
 
 	// Update the conflicts array and remove conflicting nodes
-	numConfChecks++;
+	Counter::estimate(1 + 2 * (unsigned long long)neighbors[bestNode][0]);
+	Counter::add(1);
 	for (int j=1; j<=neighbors[bestNode][0]; j++) {
 		int i = neighbors[bestNode][j];
-		numConfChecks++;
+		Counter::add(1);
 			
 		// Do not move neighbors to bestColor for a couple of iterations in order to
 		// avoid bestNode from dropping back out too soon
@@ -88,7 +116,7 @@ void moveNodeToColor(int bestNode, int bestColor, Graph & g, int * c, int ** nod
 
 		// Increase the conflicts for bestColor
 		conflicts[bestColor][i]++;
-		numConfChecks++;
+		Counter::add(1);
 		
 		// Check for conflict created by moving bestNode to bestColor
 		if (c[i] == bestColor) {
@@ -98,15 +126,17 @@ void moveNodeToColor(int bestNode, int bestColor, Graph & g, int * c, int ** nod
 			nodesByColor[0][ (nbcPosition[i]=++nodesByColor[0][0]) ] = i;
 			c[i] = 0;
 			// Reduce the conflicts of all neighbors.
-			numConfChecks++;
+			Counter::estimate(1 + 2 * (unsigned long long)neighbors[i][0]);
+			Counter::add(1);
 			for (int k=1; k<=neighbors[i][0]; k++) {
 				conflicts[bestColor][ neighbors[i][k] ]--;
-				numConfChecks+=2;
+				Counter::add(2);
 			}
 		}
 	}
 }
 
+template<class Counter>
 void moveNodeToColorForTabu(int bestNode, int bestColor, Graph & g, int * c, int ** nodesByColor, int ** conflicts, int * nbcPosition, int ** neighbors, 
 	int * nodesInConflict, int * confPosition, int ** tabuStatus,  long totalIterations, int tabuTenure) 
 {
@@ -115,13 +145,13 @@ void moveNodeToColorForTabu(int bestNode, int bestColor, Graph & g, int * c, int
 	c[bestNode] = bestColor;
 
 	// If bestNode is not a conflict node anymore, remove it from the list
-	numConfChecks+=2; 
+	Counter::add(2); 
 	if (conflicts[oldColor][bestNode] && !(conflicts[bestColor][bestNode])) {
 		confPosition[nodesInConflict[nodesInConflict[0]]] = confPosition[bestNode];
 		nodesInConflict[confPosition[bestNode]] = nodesInConflict[nodesInConflict[0]--];  
 	} 
 	else {
-		numConfChecks+=2;
+		Counter::add(2);
 		// If bestNode becomes a conflict node, add it to the list
 		if (!(conflicts[oldColor][bestNode]) && conflicts[bestColor][bestNode]) {
 			nodesInConflict[ (confPosition[bestNode] = ++nodesInConflict[0]) ] = bestNode;
@@ -129,10 +159,11 @@ void moveNodeToColorForTabu(int bestNode, int bestColor, Graph & g, int * c, int
 	}
 
 	// Update the conflicts of the neighbors.
-	numConfChecks++;
+	Counter::estimate(3 + 3 * (unsigned long long)neighbors[bestNode][0]);
+	Counter::add(1);
 	for (int i=1; i<=neighbors[bestNode][0]; i++) {
 		int nb = neighbors[bestNode][i];
-		numConfChecks+=2;
+		Counter::add(2);
 		// Decrease the number of conflicts in the old color
 		if ((--conflicts[oldColor][nb]) == 0 && c[nb] == oldColor) {
 			// Remove nb from the list of conflicting nodes if there are 0 conflicts in
@@ -141,7 +172,7 @@ void moveNodeToColorForTabu(int bestNode, int bestColor, Graph & g, int * c, int
 			nodesInConflict[confPosition[nb]] = nodesInConflict[nodesInConflict[0]--];  
 		}
 		// Increase the number of conflicts in the new color
-		numConfChecks++;
+		Counter::add(1);
 		if ((++conflicts[bestColor][nb]) == 1 && c[nb] == bestColor) {
 			// Add nb from the list conflicting nodes if there is a new conflict in
 			// its own color
@@ -152,17 +183,27 @@ void moveNodeToColorForTabu(int bestNode, int bestColor, Graph & g, int * c, int
 	tabuStatus[bestNode][oldColor] = totalIterations + tabuTenure;
 }
 
+// Both counting policies are compiled in, the solver picks one through CheckCounter
+template void moveNodeToColor<CountChecks>(int, int, Graph &, int *, int **, int **, int *, int **, int **, long, int);
+template void moveNodeToColor<EstimateChecks>(int, int, Graph &, int *, int **, int **, int *, int **, int **, long, int);
+template void moveNodeToColorForTabu<CountChecks>(int, int, Graph &, int *, int **, int **, int *, int **, int *, int *, int **, long, int);
+template void moveNodeToColorForTabu<EstimateChecks>(int, int, Graph &, int *, int **, int **, int *, int **, int *, int *, int **, long, int);
+
 void freeArrays(int ** & nodesByColor, int ** & conflicts, int ** & tabuStatus, int * & nbcPosition, int k, int n) 
 {
-	for (int i=0; i<=k; i++) {
-		delete[] nodesByColor[i];
-		delete[] conflicts[i];
-	}
-	for (int i=0; i<n; i++) {
-		delete[] tabuStatus[i];
-	}
-	delete[] nodesByColor;
-	delete[] conflicts;
-	delete[] tabuStatus;
-	delete[] nbcPosition;
+	// The arrays stay in the arena of this thread for its next search
+	nodesByColor = conflicts = tabuStatus = NULL;
+	nbcPosition = NULL;
+}
+
+void releaseArrayCache()
+{
+	freeArena(arena.base, arena.size, arena.mode);
+	arena.base = NULL;
+	arena.size = 0;
+}
+
+int arrayPages()
+{
+	return arena.base == NULL ? -1 : arena.mode;
 }
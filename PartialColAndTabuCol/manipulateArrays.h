@@ -5,13 +5,22 @@
 
 void makeAdjList(int **neighbors, Graph &g);
 
-void initializeArrays(int ** & nodesByColor, int ** & conflicts, int ** & tabuStatus, int * & nbcPosition, Graph & g, int * c, int k);
+void initializeArrays(int ** & nodesByColor, int ** & conflicts, int ** & tabuStatus, int * & nbcPosition, Graph & g, int * c, int k, int ** neighbors);
 
+template<class Counter>
 void moveNodeToColor(int bestNode, int bestColor, Graph & g, int * c, int ** nodesByColor, int ** conflicts, int * nbcPosition, int ** neighbors, 
 	int ** tabuStatus,  long totalIterations, int tabuTenure);
   
 void freeArrays(int ** & nodesByColor, int ** & conflicts, int ** & tabuStatus, int * & nbcPosition, int k, int n);
 
+// Frees the arrays kept by the calling thread for its next search; call it before a thread that
+// made searches ends
+void releaseArrayCache();
+
+// The kind of pages (HUGEPAGES_NONE...) of the arena of the calling thread, -1 if it has none yet
+int arrayPages();
+
+template<class Counter>
 void moveNodeToColorForTabu(int bestNode, int bestColor, Graph & g, int * c, int ** nodesByColor, int ** conflicts, int * nbcPosition, int ** neighbors, 
 	int * nodesInConflict, int * confPosition,	int ** tabuStatus,  long totalIterations, int tabuTenure);
 
@@ -0,0 +1,212 @@
+#include "parallelScan.h"
+#include "rng.h"
+#include <stdlib.h>
+#include <limits.h>
+
+using namespace std;
+
+#define JOB_TABU 1
+#define JOB_REACTCOL 2
+
+ParallelScan::ParallelScan(int nThreads, long long thresh)
+{
+	numThreads = nThreads < 1 ? 1 : nThreads;
+	threshold = thresh;
+	generation = 0;
+	pending = 0;
+	stop = false;
+	job = 0;
+	results.resize(numThreads);
+	// Every slice has its own generator state so that tie-breaking inside a slice does not contend on rngState
+	for (int i = 0; i < numThreads; i++) {
+		unsigned long long seed = (unsigned long long)randomInt() << 31;
+		sliceRandom.push_back(seed | randomInt());
+	}
+	// Slice 0 is evaluated by the calling thread, the others by the pool
+	for (int i = 1; i < numThreads; i++) workers.push_back(thread(&ParallelScan::workerLoop, this, i));
+}
+
+ParallelScan::~ParallelScan()
+{
+	{
+		unique_lock<mutex> guard(lock);
+		stop = true;
+	}
+	startCond.notify_all();
+	for (size_t i = 0; i < workers.size(); i++) workers[i].join();
+}
+
+bool ParallelScan::engage(int numNodes, int numColors)
+{
+	return numThreads > 1 && (long long)numNodes * numColors >= threshold;
+}
+
+void ParallelScan::workerLoop(int id)
+{
+	unsigned long seen = 0;
+	while (true) {
+		{
+			unique_lock<mutex> guard(lock);
+			startCond.wait(guard, [&] { return stop || generation != seen; });
+			if (stop) return;
+			seen = generation;
+		}
+		evalSlice(id);
+		{
+			unique_lock<mutex> guard(lock);
+			if (--pending == 0) doneCond.notify_one();
+		}
+	}
+}
+
+void ParallelScan::runSlices()
+{
+	{
+		unique_lock<mutex> guard(lock);
+		pending = numThreads - 1;
+		generation++;
+	}
+	startCond.notify_all();
+	evalSlice(0);
+	unique_lock<mutex> guard(lock);
+	doneCond.wait(guard, [&] { return pending == 0; });
+}
+
+void ParallelScan::evalSlice(int id)
+{
+	// Split the list positions 1..list[0] into numThreads contiguous slices
+	int size = list[0];
+	int begin = 1 + (int)((long long)size * id / numThreads);
+	int end = 1 + (int)((long long)size * (id + 1) / numThreads);
+	SliceResult &r = results[id];
+	r.bestNode = -1;
+	r.bestColor = -1;
+	r.bestValue = INT_MAX;
+	r.numBest = 0;
+	r.checks = 0;
+	if (job == JOB_TABU) evalTabuSlice(id, begin, end);
+	else evalReactcolSlice(id, begin, end);
+}
+
+void ParallelScan::evalTabuSlice(int id, int begin, int end)
+{
+	SliceResult &r = results[id];
+	unsigned long long &gen = sliceRandom[id];
+	for (int iNode = begin; iNode < end; iNode++) {
+		int node = list[iNode];
+		int cur = conflicts[c[node]][node];
+		for (int color = 1; color <= k; color++) {
+			if (color != c[node]) {
+				r.checks += 2;
+				int newValue = totalConflicts + conflicts[color][node] - cur;
+				if (newValue <= r.bestValue) {
+					// Only consider the move if it is not tabu or leads to a new very best solution seen globally.
+					if (tabuStatus[node][color] < totalIterations || newValue < bestSolutionValue) {
+						if (newValue < r.bestValue) {
+							r.bestValue = newValue;
+							r.numBest = 0;
+						}
+						// Select the nth move with probability 1/n
+						if (nextRandom(gen) % (r.numBest + 1) == 0) {
+							r.bestNode = node;
+							r.bestColor = color;
+						}
+						r.numBest++;
+					}
+				}
+			}
+		}
+	}
+}
+
+void ParallelScan::evalReactcolSlice(int id, int begin, int end)
+{
+	SliceResult &r = results[id];
+	unsigned long long &gen = sliceRandom[id];
+	for (int iOutNode = begin; iOutNode < end; iOutNode++) {
+		int outNode = list[iOutNode];
+		for (int color = 1; color <= k; color++) {
+			r.checks++;
+			int value = conflicts[color][outNode];
+			if (value <= r.bestValue) {
+				r.checks += 2;
+				// Only consider the move if it is not tabu or leads to a new very best solution seen globally.
+				if (tabuStatus[outNode][color] < totalIterations || (value == 0 && aspiration)) {
+					if (value < r.bestValue) {
+						r.bestValue = value;
+						r.numBest = 0;
+					}
+					if (nextRandom(gen) % (r.numBest + 1) == 0) {
+						r.bestNode = outNode;
+						r.bestColor = color;
+						r.checks++;
+					}
+					r.numBest++;
+				}
+			}
+		}
+	}
+}
+
+unsigned long long ParallelScan::merge(int &bestNode, int &bestColor, int &bestValue)
+{
+	// Pick a slice with probability proportional to its number of best moves, which makes the
+	// final choice uniform over all admissible moves of minimal cost
+	int value = INT_MAX;
+	long long total = 0;
+	unsigned long long checks = 0;
+	for (int i = 0; i < numThreads; i++) {
+		checks += results[i].checks;
+		if (results[i].numBest == 0) continue;
+		if (results[i].bestValue < value) {
+			value = results[i].bestValue;
+			total = 0;
+		}
+		if (results[i].bestValue == value) total += results[i].numBest;
+	}
+	bestNode = -1;
+	bestColor = -1;
+	if (total == 0) return checks;
+	long long pick = (long long)(((unsigned long long)randomInt() * ((unsigned long long)RANDOM_MAX + 1) + randomInt()) % total);
+	for (int i = 0; i < numThreads; i++) {
+		if (results[i].numBest == 0 || results[i].bestValue != value) continue;
+		if (pick < results[i].numBest) {
+			bestNode = results[i].bestNode;
+			bestColor = results[i].bestColor;
+			bestValue = value;
+			return checks;
+		}
+		pick -= results[i].numBest;
+	}
+	return checks;
+}
+
+unsigned long long ParallelScan::scanTabu(int *nodesInConflict, int *colors, int **conf, int **tabu, int numColors, long iterations,
+	int conflictsNow, int bestSolution, int &bestNode, int &bestColor, int &bestValue)
+{
+	job = JOB_TABU;
+	list = nodesInConflict;
+	c = colors;
+	conflicts = conf;
+	tabuStatus = tabu;
+	k = numColors;
+	totalIterations = iterations;
+	totalConflicts = conflictsNow;
+	bestSolutionValue = bestSolution;
+	runSlices();
+	return merge(bestNode, bestColor, bestValue);
+}
+
+unsigned long long ParallelScan::scanReactcol(int *outNodes, int **conf, int **tabu, int numColors, long iterations,
+	bool aspirationMove, int &bestNode, int &bestColor, int &bestValue)
+{
+	job = JOB_REACTCOL;
+	list = outNodes;
+	conflicts = conf;
+	tabuStatus = tabu;
+	k = numColors;
+	totalIterations = iterations;
+	aspiration = aspirationMove;
+	runSlices();
+	return merge(bestNode, bestColor, bestValue);
+}
@@ -0,0 +1,73 @@
+#ifndef PARALLELSCAN_INCLUDED
+#define PARALLELSCAN_INCLUDED
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// A persistent pool of worker threads used to split the move evaluation of one tabu()/reactcol()
+// iteration. Each thread scans a slice of the conflict list (nodesInConflict or nodesByColor[0]),
+// keeps its own best move with reservoir sampling, and the slices are then merged so that every
+// admissible move of minimal cost is still selected with the same probability.
+class ParallelScan {
+public:
+
+	ParallelScan(int numThreads, long long threshold);
+	~ParallelScan();
+
+	// True if a scan over numNodes nodes and k colours is large enough to be split
+	bool engage(int numNodes, int k);
+
+	// The scans return the checks made by the slices, which the caller counts through its
+	// CheckCounter policy like those of its own loop
+	unsigned long long scanTabu(int *nodesInConflict, int *c, int **conflicts, int **tabuStatus, int k, long totalIterations,
+		int totalConflicts, int bestSolutionValue, int &bestNode, int &bestColor, int &bestValue);
+
+	unsigned long long scanReactcol(int *outNodes, int **conflicts, int **tabuStatus, int k, long totalIterations,
+		bool aspiration, int &bestNode, int &bestColor, int &bestValue);
+
+	// Generator states of the slices, saved and restored by checkpoints
+	std::vector<unsigned long long> &sliceRandomState() { return sliceRandom; }
+
+private:
+
+	struct SliceResult {
+		int bestNode, bestColor, bestValue;
+		long long numBest;
+		unsigned long long checks;
+	};
+
+	void workerLoop(int id);
+	void runSlices();
+	void evalSlice(int id);
+	void evalTabuSlice(int id, int begin, int end);
+	void evalReactcolSlice(int id, int begin, int end);
+	unsigned long long merge(int &bestNode, int &bestColor, int &bestValue);
+
+	int numThreads;
+	long long threshold;
+	std::vector<std::thread> workers;
+	std::vector<unsigned long long> sliceRandom;
+	std::vector<SliceResult> results;
+
+	std::mutex lock;
+	std::condition_variable startCond, doneCond;
+	unsigned long generation;
+	int pending;
+	bool stop;
+
+	// Description of the scan currently being run
+	int job;
+	int *list;
+	int *c;
+	int **conflicts;
+	int **tabuStatus;
+	int k;
+	long totalIterations;
+	int totalConflicts;
+	int bestSolutionValue;
+	bool aspiration;
+};
+
+#endif
@@ -1,14 +1,20 @@
 #include "reactcol.h"
 #include "initializeColoring.h" 
 #include "manipulateArrays.h"
+#include "parallelScan.h"
+#include "timeLimit.h"
+#include "checkCounter.h"
+#include "kBuckets.h"
+#include "rng.h"
+#include "checkpoint.h"
+#include "trace.h"
 #include <iostream>
 #include <stdlib.h>
 
 using namespace std;
 
-extern unsigned long long numConfChecks;
-
-long reactcol(Graph &g, int *c, int k, unsigned long long maxChecks, int staticTenure, int verbose, int freq, int inc, int **neighbors) {
+template<class Counter, bool Reactive, bool Verbose, int KMax>
+static long reactcolSearch(Graph &g, int *c, int k, unsigned long long maxChecks, int staticTenure, int verbose, int freq, int inc, int **neighbors, ParallelScan *pool, Checkpointer *ckpt, Tracer *trace, const Deadline &deadline) {
 
 	int **nodesByColor; // Arrays of nodes for each color
 	int *nbcPosition;   // Position of each node in the above array
@@ -57,75 +63,122 @@ long reactcol(Graph &g, int *c, int k, unsigned long long maxChecks, int staticT
 		randomTenure = 0;
 	}
 
-	initializeColoring(g, c, k);
+	//Make the initial solution, or take the one of the checkpoint being resumed
+	bool resumed = ckpt != NULL && ckpt->resuming;
+	if (resumed) ckpt->resumeColouring(g, c, 1, k);
+	else initializeColoring(g, c, k, neighbors);
 	//if (verbose>1) cout << "Initialized the coloring\n";
 
-	initializeArrays(nodesByColor, conflicts, tabuStatus, nbcPosition, g, c, k);
+	initializeArrays(nodesByColor, conflicts, tabuStatus, nbcPosition, g, c, k, neighbors);
 	//if (verbose>1) cout << "Initialized the arrays. |Outnodes| = " << nodesByColor[0][0] << endl;
 
 	int bestSolutionValue = nodesByColor[0][0]; // Number of out nodes
 
 	// Just in case we already have an admissible k-coloring
 	if (bestSolutionValue == 0) {
+		freeArrays(nodesByColor, conflicts, tabuStatus, nbcPosition, k, g.n);
+		searchIterations = 0;
 		return 0;
 	}
 
 	int minSolutionValue = g.n;
 	int maxSolutionValue = 0;
 
+	SearchState state;
+	if (resumed) {
+		ckpt->resumeSearch(state, g, nodesByColor, nbcPosition, NULL, NULL, tabuStatus);
+		totalIterations = state.totalIterations;
+		currentIterations = state.currentIterations;
+		bestSolutionValue = state.bestSolutionValue;
+		minSolutionValue = state.minSolutionValue;
+		maxSolutionValue = state.maxSolutionValue;
+		tabuTenure = state.tabuTenure;
+		randomTenure = state.randomTenure;
+		pairCycles = state.pairCycles;
+		frequency = state.frequency;
+		increment = state.increment;
+		nextPair = state.nextPair;
+		nextVerbose = state.nextVerbose;
+	}
+
 	while (numConfChecks < maxChecks) {
 
+		// Poll the clock every TIME_POLL iterations, and write a checkpoint when one is due
+		if (totalIterations % TIME_POLL == 0) {
+			if (deadlinePassed(deadline)) break;
+			if (ckpt != NULL && ckpt->due()) {
+				SearchState now = { 1, k, totalIterations, currentIterations, 0, bestSolutionValue, minSolutionValue, maxSolutionValue,
+					tabuTenure, randomTenure, pairCycles, frequency, increment, nextPair, nextVerbose };
+				ckpt->saveSearch(now, g, c, nodesByColor, NULL, tabuStatus);
+			}
+		}
+
 		currentIterations++;
 		totalIterations++;
 
+		int nc = nodesByColor[0][0];
 		int bestNode=-1, bestColor=-1, bestValue=g.n;
 		int numBest=0;
 
-		// Try for every uncolored outNode
-		for (int iOutNode=1; iOutNode <= nodesByColor[0][0]; iOutNode++) {
-			int outNode = nodesByColor[0][iOutNode];
-			// to move it to every color
-
-			for (int color=1; color<=k; color++) {
-				numConfChecks++;
-				if (conflicts[color][outNode] <= bestValue) {
-					numConfChecks++;
-					if (conflicts[color][outNode] < bestValue) {
-						numBest=0;
-					}
-
-					// Only consider the move if it is not tabu or leads to a new very best solution seen globally.
-					numConfChecks++;
-					if (tabuStatus[outNode][color] < totalIterations || (conflicts[color][outNode] == 0 && nodesByColor[0][0] == bestSolutionValue)) {	  
+		Counter::estimate((unsigned long long)nodesByColor[0][0] * k);
+		if (pool != NULL && pool->engage(nodesByColor[0][0], k)) {
+			// Large neighbourhood: let the worker pool scan slices of the uncolored nodes
+			Counter::add(pool->scanReactcol(nodesByColor[0], conflicts, tabuStatus, k, totalIterations, nodesByColor[0][0] == bestSolutionValue, bestNode, bestColor, bestValue));
+		}
+		else {
+			bool aspiration = (nodesByColor[0][0] == bestSolutionValue);
+			// Try for every uncolored outNode
+			for (int iOutNode=1; iOutNode <= nodesByColor[0][0]; iOutNode++) {
+				int outNode = nodesByColor[0][iOutNode];
+				// to move it to every color
+
+				UNROLL_COLOURS
+				for (int color=1; color<=(KMax ? KMax : k); color++) {
+					if (KMax && color > k) break;
+					Counter::add(1);
+					int value = conflicts[color][outNode];
+					if (value <= bestValue) {
+						Counter::add(1);
+						if (value < bestValue) {
+							numBest=0;
+						}
 
-						// Select the nth move with probability 1/n
-						if (rand()%(numBest+1)==0) {
-							bestNode = outNode;
-							bestColor = color;
-							numConfChecks++;
-							bestValue = conflicts[color][outNode];
+						// Only consider the move if it is not tabu or leads to a new very best solution seen globally.
+						Counter::add(1);
+						if (tabuStatus[outNode][color] < totalIterations || (value == 0 && aspiration)) {	  
+
+							// Select the nth move with probability 1/n
+							if (randomInt()%(numBest+1)==0) {
+								bestNode = outNode;
+								bestColor = color;
+								Counter::add(1);
+								bestValue = value;
+							}
+							numBest++;  // Count the number of considered moves
 						}
-						numBest++;  // Count the number of considered moves
 					}
 				}
 			}
 		}
 		// If no non tabu moves have been found, take any random move
 		if (bestNode == -1) {
-			bestNode = nodesByColor[0][(rand()%nodesByColor[0][0])+1];
-			bestColor = (rand()%k)+1;
+			bestNode = nodesByColor[0][(randomInt()%nodesByColor[0][0])+1];
+			bestColor = (randomInt()%k)+1;
 			bestValue = conflicts[bestColor][bestNode];
-			numConfChecks++;
+			Counter::add(1);
 		}
 
 		int tTenure = tabuTenure;
-		if (randomTenure == 1){
+		if (Reactive && randomTenure == 1){
 			if(tTenure == 0) tTenure++;
-			else tTenure = (rand()%tTenure)+1;
+			else tTenure = (randomInt()%tTenure)+1;
 		}
 
 		// Now execute the move
-		moveNodeToColor(bestNode, bestColor, g, c, nodesByColor, conflicts, nbcPosition, neighbors,  tabuStatus, totalIterations, tTenure);
+		moveNodeToColor<Counter>(bestNode, bestColor, g, c, nodesByColor, conflicts, nbcPosition, neighbors,  tabuStatus, totalIterations, tTenure);
+
+		if (trace != NULL && trace->sample(totalIterations))
+			trace->record(totalIterations, k, nodesByColor[0][0], nodesByColor[0][0] < bestSolutionValue ? nodesByColor[0][0] : bestSolutionValue, tTenure, nc, bestNode, bestColor);
 
 		// Update the min and max objective function value
 		if (nodesByColor[0][0] > maxSolutionValue) maxSolutionValue = nodesByColor[0][0];
@@ -133,7 +186,7 @@ long reactcol(Graph &g, int *c, int k, unsigned long long maxChecks, int staticT
 
 		int Delta = maxSolutionValue - minSolutionValue;
 
-		if (staticTenure == 0) {
+		if (Reactive) {
 
 			if (currentIterations % frequency == 0) {
 				// Adjust the tabuTenure every frequency iterations
@@ -141,13 +194,13 @@ long reactcol(Graph &g, int *c, int k, unsigned long long maxChecks, int staticT
 					tabuTenure += increment;
 					if (pairCycles == nextPair) {
 						if (!freq) { // frequency and incrment are not set manually
-							int p = rand()%numPairs;
+							int p = randomInt()%numPairs;
 							frequency = pairs[p][0];
 							increment = pairs[p][1];
 							pairCycles = 0;
 							nextPair = pairs[p][2];
 						}
-						randomTenure = rand()%2;
+						randomTenure = randomInt()%2;
 					} else {
 						pairCycles++;
 					}
@@ -160,7 +213,7 @@ long reactcol(Graph &g, int *c, int k, unsigned long long maxChecks, int staticT
 
 			}
 		} else {
-			tabuTenure = (int)(0.6*nodesByColor[0][0]) + rand()%10;
+			tabuTenure = (int)(0.6*nodesByColor[0][0]) + randomInt()%10;
 		}
 
 		// Have we a new globally best solution?
@@ -180,7 +233,7 @@ long reactcol(Graph &g, int *c, int k, unsigned long long maxChecks, int staticT
 			nextVerbose = totalIterations;
 		}
 
-		if(verbose>=2 && totalIterations % 1000 == 0)
+		if(Verbose && totalIterations % 1000 == 0)
 			cout<<"          -> Iteration "<<totalIterations<<" Cost = "<<nodesByColor[0][0]<<endl;
 
 
@@ -191,7 +244,27 @@ long reactcol(Graph &g, int *c, int k, unsigned long long maxChecks, int staticT
 
 	freeArrays(nodesByColor, conflicts, tabuStatus, nbcPosition, k, g.n);
 
-	if(verbose>=2)cout<<"          -> Iteration "<<totalIterations<<" Cost = "<<bestSolutionValue<<endl;
+	if(Verbose)cout<<"          -> Iteration "<<totalIterations<<" Cost = "<<bestSolutionValue<<endl;
+	searchIterations = totalIterations;
 
 	return bestSolutionValue;
 }
+
+template<class Counter, bool Reactive, bool Verbose>
+static long reactcolForK(Graph &g, int *c, int k, unsigned long long maxChecks, int staticTenure, int verbose, int freq, int inc, int **neighbors, ParallelScan *pool, Checkpointer *ckpt, Tracer *trace, const Deadline &deadline)
+{
+	if (k <= K_SMALL) return reactcolSearch<Counter, Reactive, Verbose, K_SMALL>(g, c, k, maxChecks, staticTenure, verbose, freq, inc, neighbors, pool, ckpt, trace, deadline);
+	if (k <= K_MEDIUM) return reactcolSearch<Counter, Reactive, Verbose, K_MEDIUM>(g, c, k, maxChecks, staticTenure, verbose, freq, inc, neighbors, pool, ckpt, trace, deadline);
+	return reactcolSearch<Counter, Reactive, Verbose, K_GENERIC>(g, c, k, maxChecks, staticTenure, verbose, freq, inc, neighbors, pool, ckpt, trace, deadline);
+}
+
+long reactcol(Graph &g, int *c, int k, unsigned long long maxChecks, int staticTenure, int verbose, int freq, int inc, int **neighbors, ParallelScan *pool, Checkpointer *ckpt, Tracer *trace, const Deadline &deadline)
+{
+	// Pick the kernel for the tenure scheme, verbosity and size of k once, outside the search loop
+	if (staticTenure == 0) {
+		if (verbose >= 2) return reactcolForK<CheckCounter, true, true>(g, c, k, maxChecks, staticTenure, verbose, freq, inc, neighbors, pool, ckpt, trace, deadline);
+		return reactcolForK<CheckCounter, true, false>(g, c, k, maxChecks, staticTenure, verbose, freq, inc, neighbors, pool, ckpt, trace, deadline);
+	}
+	if (verbose >= 2) return reactcolForK<CheckCounter, false, true>(g, c, k, maxChecks, staticTenure, verbose, freq, inc, neighbors, pool, ckpt, trace, deadline);
+	return reactcolForK<CheckCounter, false, false>(g, c, k, maxChecks, staticTenure, verbose, freq, inc, neighbors, pool, ckpt, trace, deadline);
+}
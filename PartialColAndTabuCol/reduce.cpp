@@ -0,0 +1,145 @@
+#include "reduce.h"
+#include "threadLocal.h"
+#include <stddef.h>
+#include <deque>
+
+using namespace std;
+
+extern THREAD_LOCAL unsigned long long numConfChecks;
+
+Reduction::Reduction(Graph &g, int **neighbors, int k) : neighbors(NULL), numLowDegree(0), numDominated(0), g(g), gNeighbors(neighbors), k(k), block(NULL)
+{
+	int n = g.n;
+	vector<int> degree(n), lowDegree;
+	vector<char> alive(n, 1), queued(n, 1);
+	deque<int> toCheck;
+	for (int v = 0; v < n; v++) {
+		degree[v] = neighbors[v][0];
+		if (degree[v] < k) lowDegree.push_back(v);
+		toCheck.push_back(v);
+	}
+
+	//Taking out v can bring its neighbours below k neighbours, or make them dominated
+	auto takeOut = [&](int v, int dominator) {
+		alive[v] = 0;
+		Removed r = { v, dominator };
+		removed.push_back(r);
+		numConfChecks += neighbors[v][0];
+		for (int j = 1; j <= neighbors[v][0]; j++) {
+			int u = neighbors[v][j];
+			if (!alive[u]) continue;
+			if (--degree[u] == k - 1) lowDegree.push_back(u);
+			if (!queued[u]) {
+				queued[u] = 1;
+				toCheck.push_back(u);
+			}
+		}
+	};
+
+	while (true) {
+		//Peel the vertices of degree < k
+		while (!lowDegree.empty()) {
+			int v = lowDegree.back();
+			lowDegree.pop_back();
+			if (!alive[v]) continue;
+			takeOut(v, -1);
+			numLowDegree++;
+		}
+		if (toCheck.empty()) break;
+
+		//Is u dominated? The dominator w is a neighbour of the neighbour x of u that has the fewest
+		//neighbours left, and has at least as many neighbours as u. A vertex is only checked again
+		//once it has lost a neighbour.
+		int u = toCheck.front();
+		toCheck.pop_front();
+		queued[u] = 0;
+		if (!alive[u]) continue;
+		int x = -1;
+		for (int j = 1; j <= neighbors[u][0]; j++) {
+			int y = neighbors[u][j];
+			if (alive[y] && (x < 0 || degree[y] < degree[x])) x = y;
+		}
+		numConfChecks += neighbors[u][0];
+		if (x < 0) continue;
+		int dominator = -1;
+		for (int i = 1; i <= neighbors[x][0] && dominator < 0; i++) {
+			int w = neighbors[x][i];
+			numConfChecks++;
+			if (w == u || !alive[w] || degree[w] < degree[u] || g[u][w]) continue;
+			int *wRow = g[w];
+			int j;
+			for (j = 1; j <= neighbors[u][0]; j++) {
+				int y = neighbors[u][j];
+				numConfChecks++;
+				if (alive[y] && !wRow[y]) break;
+			}
+			if (j > neighbors[u][0]) dominator = w;
+		}
+		if (dominator >= 0) {
+			takeOut(u, dominator);
+			numDominated++;
+		}
+	}
+
+	//The graph left, with its adjacency lists cut out of one block
+	vector<int> index(n, -1);
+	size_t size = 0;
+	for (int v = 0; v < n; v++) {
+		if (!alive[v]) continue;
+		index[v] = (int)original.size();
+		original.push_back(v);
+		size += degree[v] + 1;
+	}
+	int m = (int)original.size();
+	rest.resize(m);
+	rest.nbEdges = 0;
+	if (m == 0) return;
+	this->neighbors = new int*[m];
+	block = new int[size];
+	int *row = block;
+	for (int i = 0; i < m; i++) {
+		int v = original[i];
+		this->neighbors[i] = row;
+		row[0] = 0;
+		for (int j = 1; j <= neighbors[v][0]; j++) {
+			int u = index[neighbors[v][j]];
+			if (u < 0) continue;
+			row[++row[0]] = u;
+			rest[i][u] = 1;
+		}
+		rest.nbEdges += row[0];
+		row += row[0] + 1;
+	}
+	rest.nbEdges /= 2;
+}
+
+Reduction::~Reduction()
+{
+	delete[] neighbors;
+	delete[] block;
+}
+
+void Reduction::restore(int *coloring)
+{
+	full.assign(g.n, 0);
+	taken.assign(k + 2, -1);
+	for (int i = 0; i < rest.n; i++) full[original[i]] = coloring[i];
+
+	//In reverse order, the coloured vertices are those that were left when v was taken out
+	for (int r = (int)removed.size() - 1; r >= 0; r--) {
+		int v = removed[r].node;
+		if (removed[r].dominator >= 0) {
+			full[v] = full[removed[r].dominator];
+			continue;
+		}
+		numConfChecks += gNeighbors[v][0];
+		for (int j = 1; j <= gNeighbors[v][0]; j++) {
+			int c = full[gNeighbors[v][j]];
+			if (c > 0) taken[c] = r;
+		}
+		int c = 1;
+		while (taken[c] == r) c++;
+		full[v] = c;
+	}
+	for (int v = 0; v < g.n; v++) coloring[v] = full[v];
+}
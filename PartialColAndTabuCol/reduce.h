@@ -0,0 +1,44 @@
+#ifndef REDUCE_INCLUDED
+#define REDUCE_INCLUDED
+
+#include "Graph.h"
+#include <vector>
+
+// The graph that is left for the search at one value of k once the vertices that can always be
+// coloured afterwards have been taken out, repeatedly until none is left:
+//  - a vertex with fewer than k neighbours left, which gets a colour none of them uses (k-core peeling)
+//  - a vertex u whose neighbours left are all neighbours of a vertex w that is not adjacent to u,
+//    which gets the colour of w
+// The vertices taken out are kept on a stack, and restore() colours them in the reverse order, in O(m).
+class Reduction {
+public:
+
+	Reduction(Graph &g, int **neighbors, int k);
+	~Reduction();
+
+	// coloring[i] holds the colour (1..k) of vertex i of rest. On return coloring[v] is the colour
+	// of vertex v of g, for all g.n vertices.
+	void restore(int *coloring);
+
+	Graph rest;                 // the graph left
+	int **neighbors;            // its adjacency lists
+	std::vector<int> original;  // vertex of g for each vertex of rest
+	int numLowDegree;           // vertices taken out for having fewer than k neighbours
+	int numDominated;           // vertices taken out for being dominated
+
+private:
+
+	struct Removed {
+		int node;
+		int dominator;  // -1 for a vertex of low degree
+	};
+
+	Graph &g;
+	int **gNeighbors;
+	int k;
+	std::vector<Removed> removed;
+	std::vector<int> full, taken;
+	int *block;
+};
+
+#endif
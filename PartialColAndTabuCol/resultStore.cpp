@@ -0,0 +1,78 @@
+#include "resultStore.h"
+#include <fstream>
+#include <stdlib.h>
+
+using namespace std;
+
+#define RESULT_HEADER "#graph\tprecolour\talgorithm\ttenure\ttarget\tseed\tmaxChecks\ttimeLimit\tconstructive\tstrategy\tflags\tstartK\tbestK\treached\tchecks\tseconds\n"
+
+bool ResultKey::operator<(const ResultKey &o) const
+{
+	if (graphHash != o.graphHash) return graphHash < o.graphHash;
+	if (precolourHash != o.precolourHash) return precolourHash < o.precolourHash;
+	if (algorithm != o.algorithm) return algorithm < o.algorithm;
+	if (tenure != o.tenure) return tenure < o.tenure;
+	if (target != o.target) return target < o.target;
+	if (seed != o.seed) return seed < o.seed;
+	if (maxChecks != o.maxChecks) return maxChecks < o.maxChecks;
+	if (timeLimit != o.timeLimit) return timeLimit < o.timeLimit;
+	if (constructiveAlg != o.constructiveAlg) return constructiveAlg < o.constructiveAlg;
+	if (strategy != o.strategy) return strategy < o.strategy;
+	return flags < o.flags;
+}
+
+ResultStore::ResultStore(const string &fileName)
+{
+	duplicates = 0;
+	bool empty = true;
+	ifstream in(fileName.c_str());
+	string line;
+	while (getline(in, line)) {
+		empty = false;
+		if (line.empty() || line[0] == '#') continue;
+		ResultKey key;
+		RunResult r;
+		int reached;
+		if (sscanf(line.c_str(), "%llx %llx %d %d %d %d %llu %lf %d %d %d %d %d %d %llu %lf", &key.graphHash, &key.precolourHash,
+			&key.algorithm, &key.tenure, &key.target, &key.seed, &key.maxChecks, &key.timeLimit, &key.constructiveAlg, &key.strategy,
+			&key.flags, &r.startK, &r.bestK, &reached, &r.checks, &r.seconds) != 16) continue;
+		r.reached = reached != 0;
+		r.searchK = r.bestK;
+		r.fails = r.reached ? 0 : 1;
+		if (!index.insert(make_pair(key, r)).second) duplicates++;
+	}
+	in.close();
+
+	out = fopen(fileName.c_str(), "a");
+	if (out != NULL && empty) {
+		fputs(RESULT_HEADER, out);
+		fflush(out);
+	}
+}
+
+ResultStore::~ResultStore()
+{
+	if (out != NULL) fclose(out);
+}
+
+bool ResultStore::find(const ResultKey &key, RunResult &result)
+{
+	lock_guard<mutex> guard(lock);
+	map<ResultKey, RunResult>::iterator it = index.find(key);
+	if (it == index.end()) return false;
+	result = it->second;
+	return true;
+}
+
+void ResultStore::add(const ResultKey &key, const RunResult &result)
+{
+	lock_guard<mutex> guard(lock);
+	if (!index.insert(make_pair(key, result)).second) return;
+	//One write per line, so that the lines of processes sharing the file are not mixed up
+	char line[512];
+	int len = snprintf(line, sizeof(line), "%016llx\t%016llx\t%d\t%d\t%d\t%d\t%llu\t%.17g\t%d\t%d\t%d\t%d\t%d\t%d\t%llu\t%.3f\n",
+		key.graphHash, key.precolourHash, key.algorithm, key.tenure, key.target, key.seed, key.maxChecks, key.timeLimit,
+		key.constructiveAlg, key.strategy, key.flags, result.startK, result.bestK, result.reached ? 1 : 0, result.checks, result.seconds);
+	fwrite(line, 1, len, out);
+	fflush(out);
+}
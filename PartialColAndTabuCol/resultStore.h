@@ -0,0 +1,62 @@
+#ifndef RESULTSTORE_INCLUDED
+#define RESULTSTORE_INCLUDED
+
+#include "solve.h"
+#include <map>
+#include <mutex>
+#include <string>
+#include <stdio.h>
+
+// Everything that decides the outcome of a run
+struct ResultKey {
+	unsigned long long graphHash;      // hashGraphFile() of the graph
+	unsigned long long precolourHash;  // hash of the precolouring, 0 = none
+	int algorithm;                     // 1 = PartialCol, 2 = TabuCol
+	int tenure;                        // 0 = reactive, 1 = dynamic
+	int target;
+	int seed;
+	unsigned long long maxChecks;
+	double timeLimit;
+	int constructiveAlg;
+	int strategy;                      // KSEARCH_...
+	int flags;                         // RESULT_REDUCE | RESULT_COMPONENTS | the --clique mode << RESULT_CLIQUE_SHIFT
+
+	bool operator<(const ResultKey &o) const;
+};
+
+#define RESULT_REDUCE 1
+#define RESULT_COMPONENTS 2
+// The --clique mode is kept in the bits from here, so that the runs stored before it was an
+// option, which had no clique bound, keep the mode CLIQUE_NONE
+#define RESULT_CLIQUE_SHIFT 2
+
+// The results of earlier runs, so that a sweep only makes the runs it has not made before. The
+// file is a text file with one tab-separated line per run, appended to as runs finish (so that
+// several processes can share it), and read into an index when the store is opened. When a key
+// appears more than once, the first line counts.
+class ResultStore {
+public:
+
+	// Reads the file if it exists; fail() is then true if it cannot be appended to
+	ResultStore(const std::string &fileName);
+	~ResultStore();
+
+	bool fail() { return out == NULL; }
+
+	// Returns false if the run has not been made
+	bool find(const ResultKey &key, RunResult &result);
+	// Records a run, unless it is already known. Can be called from several threads.
+	void add(const ResultKey &key, const RunResult &result);
+
+	const std::map<ResultKey, RunResult> &records() { return index; }
+	int numDuplicates() { return duplicates; }
+
+private:
+
+	std::map<ResultKey, RunResult> index;
+	std::mutex lock;
+	FILE *out;
+	int duplicates;
+};
+
+#endif
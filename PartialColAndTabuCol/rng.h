@@ -0,0 +1,34 @@
+#ifndef RNG_INCLUDED
+#define RNG_INCLUDED
+
+#include "threadLocal.h"
+
+// The random number generator used by the solver in place of rand(). The state of rand() cannot
+// be read back, whereas this generator (splitmix64) keeps all of its state in rngState, so a
+// checkpoint can store it and a resumed run continues with the same random numbers. Every thread
+// has its own state.
+extern THREAD_LOCAL unsigned long long rngState;
+
+#define RANDOM_MAX 0x7fffffff
+
+inline void seedRandom(unsigned long long seed)
+{
+	rngState = seed;
+}
+
+// Uniform in [0, RANDOM_MAX], drawn from the given state
+inline int nextRandom(unsigned long long &state)
+{
+	unsigned long long z = (state += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return (int)((z ^ (z >> 31)) >> 33);
+}
+
+// Uniform in [0, RANDOM_MAX], used like rand()
+inline int randomInt()
+{
+	return nextRandom(rngState);
+}
+
+#endif
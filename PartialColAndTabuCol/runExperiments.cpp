@@ -0,0 +1,384 @@
+/******************************************************************************/
+//  Runs a grid of experiments (graphs x algorithms x tenure schemes x seeds x target k) with
+//  PartialCol and TabuCol in one process, one run per job, on a work-stealing pool of threads.
+//
+//  Every run is the same as the first run of "PartialColAndTabuCol -r <seed> -T <target>" with the
+//  matching -t, -tt and --clique options. A line per run is written to the output file as soon as it
+//  finishes, and when all runs have finished the success rate and the time to target are printed
+//  for every configuration, and appended to resultsLog.log in its usual format. With --store the
+//  runs already made (in this or an earlier sweep) are taken from the result store instead of
+//  being made again, and --query prints the success rates of everything in the store.
+/******************************************************************************/
+
+#include "Graph.h"
+#include "inputGraph.h"
+#include "manipulateArrays.h"
+#include "kSearch.h"
+#include "solve.h"
+#include "resultStore.h"
+#include "clique.h"
+#include "arena.h"
+#include "workStealing.h"
+#include "timeLimit.h"
+#include "threadLocal.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+//This makes sure the compiler uses _strtoui64(x, y, z) with Microsoft Compilers, otherwise strtoull(x, y, z) is used
+#ifdef _MSC_VER
+  #define strtoull(x, y, z) _strtoui64(x, y, z)
+#endif
+
+using namespace std;
+
+THREAD_LOCAL unsigned long long numConfChecks;
+THREAD_LOCAL unsigned long long rngState = 1;
+
+void usage() {
+	cout<<"Batch experiments with PartialCol and TabuCol\n\n"
+		<<"USAGE:\n"
+		<<"--graphs <file,file,...>  (Required. Files must be in DIMACS format)\n"
+		<<"--targets <list>          (Required. Target numbers of colours, e.g. 22,23 or 20-24)\n"
+		<<"--algorithms <list>       (partialcol and/or tabucol. DEFAULT = partialcol,tabucol)\n"
+		<<"--tenures <list>          (reactive and/or dynamic. DEFAULT = reactive,dynamic)\n"
+		<<"--seeds <list>            (Random seeds, e.g. 1-5 or 1,3,7. DEFAULT = 1-5)\n"
+		<<"-s <int>                  (Stopping criteria per run, as number of constraint checks. DEFAULT = 2,147,483,647.)\n"
+		<<"--time-limit <sec>        (Wall-clock seconds allowed per run. DEFAULT = no limit.)\n"
+		<<"-a <int>                  (Construction algorithm. DSsatur = 1, Greedy = 2, RLF = 3. DEFAULT = 1.)\n"
+		<<"--k-search <int>          (Linear descent = 1, Bisection = 2, Galloping = 3. DEFAULT = 1.)\n"
+		<<"--clique <int>            (Lower bound from a clique, found once per graph. None = 0, Greedy = 1, Exact for small graphs = 2. DEFAULT = 1.)\n"
+		<<"--reduce                  (Take out the vertices of degree < k and the dominated vertices before each k.)\n"
+		<<"--components              (Search the connected components of the graph separately, one after the other.)\n"
+		<<"--workers <int>           (Number of runs made at the same time. DEFAULT = number of cores.)\n"
+		<<"--out <file>              (One line per run. DEFAULT = experiments.csv)\n"
+		<<"--huge-pages <int>        (Pages of the search arrays, as for PartialColAndTabuCol. DEFAULT = 0.)\n"
+		<<"--store <file>            (Result store: the runs found in it are not made again, and the new runs are added to it. DEFAULT = none.)\n"
+		<<"--query                   (Only print the success rates of the runs in --store, for the --graphs given or for all graphs.)\n"
+		<<"-v                        (If present, every run is reported on the screen when it finishes.)\n"
+		<<"****\n";
+	exit(1);
+}
+
+static vector<string> splitList(const char *arg)
+{
+	vector<string> items;
+	stringstream in(arg);
+	string item;
+	while (getline(in, item, ',')) if (!item.empty()) items.push_back(item);
+	return items;
+}
+
+// "1-5,8" -> 1 2 3 4 5 8
+static vector<int> intList(const char *arg)
+{
+	vector<int> values;
+	vector<string> items = splitList(arg);
+	for (size_t i = 0; i < items.size(); i++) {
+		int from, to;
+		if (sscanf(items[i].c_str(), "%d-%d", &from, &to) == 2) {
+			for (int v = from; v <= to; v++) values.push_back(v);
+		}
+		else values.push_back(atoi(items[i].c_str()));
+	}
+	return values;
+}
+
+struct Job {
+	int graph, algorithm, tenure, seed, target;
+	RunResult result;
+};
+
+static void summaryHeader()
+{
+	cout << left << setw(24) << "graph" << setw(11) << "algorithm" << setw(9) << "tenure" << right << setw(7) << "target" << setw(7) << "runs"
+		<< setw(9) << "success" << setw(8) << "best k" << setw(11) << "TTT med" << setw(11) << "TTT p90" << setw(15) << "checks med";
+}
+
+static string tttPercentile(vector<double> times, int runs, double fraction);
+
+// Prints the summary of the runs of one configuration (without ending the line) and returns the
+// number of runs that reached the target and the best k
+static void summaryRow(const string &graph, int algorithm, int tenure, int target, const vector<RunResult> &results, int &hits, int &bestK)
+{
+	int runs = (int)results.size();
+	vector<double> times, checks;
+	hits = 0;
+	bestK = INT_MAX;
+	for (int s = 0; s < runs; s++) {
+		const RunResult &r = results[s];
+		if (r.bestK < bestK) bestK = r.bestK;
+		if (r.reached) {
+			hits++;
+			times.push_back(r.seconds);
+			checks.push_back((double)r.checks);
+		}
+	}
+	string checksMedian = tttPercentile(checks, runs, 0.5);
+	if (checksMedian != "-") checksMedian = checksMedian.substr(0, checksMedian.find('.'));
+	cout << left << setw(24) << graph << setw(11) << (algorithm == 1 ? "partialcol" : "tabucol") << setw(9) << (tenure ? "dynamic" : "reactive")
+		<< right << setw(7) << target << setw(7) << runs << setw(8) << fixed << setprecision(0) << 100.0 * hits / runs << "%" << setw(8) << bestK
+		<< setw(11) << tttPercentile(times, runs, 0.5) << setw(11) << tttPercentile(times, runs, 0.9) << setw(15) << checksMedian;
+}
+
+// --query: the runs of the store grouped by configuration, the seeds being the runs of each group
+static int queryStore(ResultStore &store, const vector<string> &graphFiles)
+{
+	map<unsigned long long, string> names;
+	for (size_t i = 0; i < graphFiles.size(); i++) {
+		bool ok;
+		unsigned long long h = hashGraphFile(graphFiles[i].c_str(), ok);
+		if (!ok) { cout << "ERROR OPENING graph FILE " << graphFiles[i] << endl; exit(1); }
+		names[h] = graphFiles[i];
+	}
+	map<ResultKey, vector<RunResult> > groups;
+	const map<ResultKey, RunResult> &records = store.records();
+	for (map<ResultKey, RunResult>::const_iterator it = records.begin(); it != records.end(); it++) {
+		if (!names.empty() && names.count(it->first.graphHash) == 0) continue;
+		ResultKey group = it->first;
+		group.seed = 0;
+		groups[group].push_back(it->second);
+	}
+	summaryHeader();
+	cout << setw(14) << "budget" << "  options\n";
+	for (map<ResultKey, vector<RunResult> >::iterator it = groups.begin(); it != groups.end(); it++) {
+		const ResultKey &k = it->first;
+		string graph;
+		if (names.count(k.graphHash)) graph = names[k.graphHash];
+		else {
+			ostringstream hex;
+			hex << std::hex << setw(16) << setfill('0') << k.graphHash;
+			graph = hex.str();
+		}
+		int hits, bestK;
+		summaryRow(graph, k.algorithm, k.tenure, k.target, it->second, hits, bestK);
+		cout << setw(14) << k.maxChecks << "  -a " << k.constructiveAlg << " --k-search " << k.strategy;
+		if (k.timeLimit > 0) cout << " --time-limit " << setprecision(3) << k.timeLimit;
+		if (k.precolourHash != 0) cout << " precoloured";
+		if (k.flags & RESULT_REDUCE) cout << " --reduce";
+		if (k.flags & RESULT_COMPONENTS) cout << " --components";
+		cout << " --clique " << (k.flags >> RESULT_CLIQUE_SHIFT);
+		cout << "\n";
+	}
+	cout << records.size() << " runs in the store";
+	if (store.numDuplicates() > 0) cout << " (" << store.numDuplicates() << " duplicate lines ignored)";
+	cout << endl;
+	return 0;
+}
+
+// Time to target of the given fraction of the runs: the runs that missed the target count as
+// infinitely long, so the percentile only exists if enough runs reached it
+static string tttPercentile(vector<double> times, int runs, double fraction)
+{
+	int rank = (int)(fraction * runs + 0.999999);
+	if (rank < 1) rank = 1;
+	if (rank > (int)times.size()) return "-";
+	sort(times.begin(), times.end());
+	ostringstream out;
+	out << fixed << setprecision(3) << times[rank - 1];
+	return out.str();
+}
+
+int main(int argc, char ** argv)
+{
+	vector<string> graphFiles, algorithmNames, tenureNames;
+	vector<int> algorithms, tenures, seeds = intList("1-5"), targets;
+	int constructiveAlg = 1, kStrategy = KSEARCH_LINEAR, cliqueMode = CLIQUE_GREEDY, verbose = 0;
+	bool reduce = false, components = false;
+	int numWorkers = thread::hardware_concurrency();
+	double timeLimit = 0;
+	unsigned long long maxChecks = INT_MAX;
+	string outFile = "experiments.csv", storeFile;
+	bool query = false;
+
+	algorithmNames.push_back("partialcol");
+	algorithmNames.push_back("tabucol");
+	tenureNames.push_back("reactive");
+	tenureNames.push_back("dynamic");
+
+	//Read in program parameters
+	for (int i = 1; i < argc; i++) {
+		if (i + 1 >= argc && strcmp("-v", argv[i]) != 0 && strcmp("--reduce", argv[i]) != 0 && strcmp("--components", argv[i]) != 0 && strcmp("--query", argv[i]) != 0) usage();
+		if (strcmp("--graphs", argv[i]) == 0) graphFiles = splitList(argv[++i]);
+		else if (strcmp("--targets", argv[i]) == 0) targets = intList(argv[++i]);
+		else if (strcmp("--algorithms", argv[i]) == 0) algorithmNames = splitList(argv[++i]);
+		else if (strcmp("--tenures", argv[i]) == 0) tenureNames = splitList(argv[++i]);
+		else if (strcmp("--seeds", argv[i]) == 0) seeds = intList(argv[++i]);
+		else if (strcmp("-s", argv[i]) == 0) maxChecks = strtoull(argv[++i], NULL, 10);
+		else if (strcmp("--time-limit", argv[i]) == 0) timeLimit = atof(argv[++i]);
+		else if (strcmp("-a", argv[i]) == 0) constructiveAlg = atoi(argv[++i]);
+		else if (strcmp("--k-search", argv[i]) == 0) kStrategy = atoi(argv[++i]);
+		else if (strcmp("--clique", argv[i]) == 0) cliqueMode = atoi(argv[++i]);
+		else if (strcmp("--workers", argv[i]) == 0) numWorkers = atoi(argv[++i]);
+		else if (strcmp("--out", argv[i]) == 0) outFile = argv[++i];
+		else if (strcmp("-v", argv[i]) == 0) verbose++;
+		else if (strcmp("--reduce", argv[i]) == 0) reduce = true;
+		else if (strcmp("--components", argv[i]) == 0) components = true;
+		else if (strcmp("--huge-pages", argv[i]) == 0) setHugePages(atoi(argv[++i]));
+		else if (strcmp("--store", argv[i]) == 0) storeFile = argv[++i];
+		else if (strcmp("--query", argv[i]) == 0) query = true;
+		else usage();
+	}
+	ResultStore *store = NULL;
+	if (!storeFile.empty()) {
+		store = new ResultStore(storeFile);
+		if (store->fail()) { cout << "ERROR OPENING store FILE " << storeFile << endl; exit(1); }
+	}
+	if (query) {
+		if (store == NULL) usage();
+		return queryStore(*store, graphFiles);
+	}
+	if (graphFiles.empty() || targets.empty() || seeds.empty()) usage();
+	for (size_t i = 0; i < algorithmNames.size(); i++) {
+		if (algorithmNames[i] == "partialcol") algorithms.push_back(1);
+		else if (algorithmNames[i] == "tabucol") algorithms.push_back(2);
+		else usage();
+	}
+	for (size_t i = 0; i < tenureNames.size(); i++) {
+		if (tenureNames[i] == "reactive") tenures.push_back(0);
+		else if (tenureNames[i] == "dynamic") tenures.push_back(1);
+		else usage();
+	}
+	if (numWorkers < 1) numWorkers = 1;
+
+	//The graphs, their adjacency lists and their clique bounds are made once and shared by all runs
+	vector<Graph *> graphs;
+	vector<int **> neighbors;
+	vector<unsigned long long> hashes;
+	vector<int> lowerBounds;
+	for (size_t i = 0; i < graphFiles.size(); i++) {
+		bool ok = true;
+		hashes.push_back(store == NULL ? 0 : hashGraphFile(graphFiles[i].c_str(), ok));
+		if (!ok) { cout << "ERROR OPENING graph FILE " << graphFiles[i] << endl; exit(1); }
+		Graph *g = new Graph;
+		inputDimacsGraph(*g, (char *)graphFiles[i].c_str());
+		int **nb = new int*[g->n];
+		makeAdjList(nb, *g);
+		bool proven;
+		graphs.push_back(g);
+		neighbors.push_back(nb);
+		lowerBounds.push_back(max(1, cliqueBound(*g, nb, cliqueMode, numWorkers, proven)));
+	}
+
+	//The grid, with the seeds innermost so that the runs of a configuration are next to each other
+	vector<Job> jobs;
+	for (size_t gi = 0; gi < graphs.size(); gi++)
+		for (size_t a = 0; a < algorithms.size(); a++)
+			for (size_t t = 0; t < tenures.size(); t++)
+				for (size_t ti = 0; ti < targets.size(); ti++)
+					for (size_t s = 0; s < seeds.size(); s++) {
+						Job job = { (int)gi, algorithms[a], tenures[t], seeds[s], targets[ti] };
+						jobs.push_back(job);
+					}
+
+	ofstream out(outFile.c_str());
+	if (out.fail()) { cout << "ERROR OPENING output FILE " << outFile << endl; exit(1); }
+	out << "graph,algorithm,tenure,seed,target,startK,bestK,reached,checks,seconds\n";
+	mutex outLock;
+	int finished = 0;
+	auto writeRun = [&](Job &job) {
+		RunResult &r = job.result;
+		out << graphFiles[job.graph] << ',' << (job.algorithm == 1 ? "partialcol" : "tabucol") << ',' << (job.tenure ? "dynamic" : "reactive") << ','
+			<< job.seed << ',' << job.target << ',' << r.startK << ',' << r.bestK << ',' << (r.reached ? 1 : 0) << ',' << r.checks << ','
+			<< fixed << setprecision(3) << r.seconds << '\n';
+	};
+	auto keyOf = [&](Job &job) {
+		ResultKey key = { hashes[job.graph], 0, job.algorithm, job.tenure, job.target, job.seed, maxChecks, timeLimit, constructiveAlg, kStrategy,
+			(reduce ? RESULT_REDUCE : 0) | (components ? RESULT_COMPONENTS : 0) | cliqueMode << RESULT_CLIQUE_SHIFT };
+		return key;
+	};
+
+	//The runs found in the store keep their results and are not made again
+	vector<int> toRun;
+	for (size_t j = 0; j < jobs.size(); j++) {
+		if (store != NULL && store->find(keyOf(jobs[j]), jobs[j].result)) writeRun(jobs[j]);
+		else toRun.push_back((int)j);
+	}
+	out.flush();
+	if (store != NULL) cout << jobs.size() - toRun.size() << " of " << jobs.size() << " runs found in " << storeFile << ", ";
+	cout << toRun.size() << " runs on " << numWorkers << " workers" << endl;
+	double start = readClock(CLOCK_WALL);
+
+	//Every worker keeps a colouring buffer large enough for all the graphs
+	int maxN = 0;
+	for (size_t i = 0; i < graphs.size(); i++) if (graphs[i]->n > maxN) maxN = graphs[i]->n;
+	vector< vector<int> > colourings(numWorkers, vector<int>(maxN));
+
+	WorkStealingPool pool(numWorkers);
+	pool.run((int)toRun.size(), [&](int j, int worker) {
+		Job &job = jobs[toRun[j]];
+		Graph &g = *graphs[job.graph];
+		int target = job.target < 2 || job.target > g.n ? 2 : job.target;
+
+		KSearchParams p;
+		p.strategy = kStrategy;
+		p.algorithm = job.algorithm;
+		p.tenure = job.tenure;
+		p.verbose = 0;
+		p.frequency = 0;
+		p.increment = 0;
+		p.targetCols = target;
+		p.lowerBound = lowerBounds[job.graph];
+		p.maxChecks = maxChecks;
+		p.clockType = CLOCK_WALL;
+		p.timeLimit = timeLimit;
+		p.kTimeLimit = 0;
+		p.pool = NULL;
+		p.checkpoint = NULL;
+		p.trace = NULL;
+		p.solution = NULL;
+		p.reduce = reduce;
+		p.components = components;
+		p.componentPool = NULL;
+		ostream confStream(NULL), timeStream(NULL);
+		rngState = 1;
+		job.result = solveRun(g, neighbors[job.graph], constructiveAlg, job.seed, p, &colourings[worker][0], confStream, timeStream);
+		if (store != NULL) store->add(keyOf(job), job.result);
+
+		RunResult &r = job.result;
+		lock_guard<mutex> guard(outLock);
+		writeRun(job);
+		out.flush();
+		finished++;
+		if (verbose >= 1)
+			cout << "[" << finished << "/" << toRun.size() << "] " << graphFiles[job.graph] << ' ' << (job.algorithm == 1 ? "partialcol" : "tabucol") << ' '
+				<< (job.tenure ? "dynamic" : "reactive") << " seed " << job.seed << " target " << job.target << ": " << r.bestK << " colours"
+				<< (r.reached ? " HIT" : " MISS") << " (" << r.checks << " checks, " << fixed << setprecision(3) << r.seconds << "s)" << endl;
+	});
+	out.close();
+	delete store;
+
+	//Summary for each configuration (the runs of a configuration are consecutive in jobs)
+	ofstream resultsLog("resultsLog.log", ios::app);
+	cout << "\nAll runs finished in " << fixed << setprecision(1) << readClock(CLOCK_WALL) - start << "s, peak resident memory " << peakResidentMB() << " MB\n\n";
+	summaryHeader();
+	cout << "\n";
+	for (size_t first = 0; first < jobs.size(); first += seeds.size()) {
+		Job &job = jobs[first];
+		vector<RunResult> results;
+		for (size_t s = 0; s < seeds.size(); s++) results.push_back(jobs[first + s].result);
+		int hits, bestK;
+		summaryRow(graphFiles[job.graph], job.algorithm, job.tenure, job.target, results, hits, bestK);
+		cout << "\n";
+		resultsLog << (job.algorithm == 1 ? "partialcol" : "tabucol") << " targetK " << job.target << " " << (job.tenure ? "dynamic" : "reactive") << " "
+			<< bestK << (hits > 0 ? " HIT " : " MISS ") << hits << " of " << results.size() << " LB " << lowerBounds[job.graph] << " (experiment " << graphFiles[job.graph] << ")" << endl;
+	}
+	resultsLog.close();
+
+	for (size_t i = 0; i < graphs.size(); i++) {
+		for (int j = 0; j < graphs[i]->n; j++) delete[] neighbors[i][j];
+		delete[] neighbors[i];
+		delete graphs[i];
+	}
+	return 0;
+}
@@ -0,0 +1,79 @@
+#include "solutionWriter.h"
+#include "../common/dimacsWriter.h"
+#include <iostream>
+#include <stdio.h>
+#include <limits.h>
+
+using namespace std;
+
+SolutionWriter::SolutionWriter(const string &file)
+{
+	fileName = file;
+	best = INT_MAX;
+	hasPending = stop = false;
+	writer = thread(&SolutionWriter::writerLoop, this);
+}
+
+SolutionWriter::~SolutionWriter()
+{
+	{
+		unique_lock<mutex> guard(lock);
+		stop = true;
+	}
+	cond.notify_all();
+	writer.join();
+}
+
+void SolutionWriter::submit(const int *colouring, int n)
+{
+	int k = 0;
+	for (int i = 0; i < n; i++) if (colouring[i] + 1 > k) k = colouring[i] + 1;
+	if (k >= best) return;
+	best = k;
+	current.assign(colouring, colouring + n);
+	{
+		unique_lock<mutex> guard(lock);
+		pending.assign(colouring, colouring + n);
+		hasPending = true;
+	}
+	cond.notify_all();
+}
+
+int SolutionWriter::bestColouring(vector<int> &colouring)
+{
+	colouring = current;
+	return best;
+}
+
+void SolutionWriter::writerLoop()
+{
+	vector<int> colouring;
+	unique_lock<mutex> guard(lock);
+	while (true) {
+		cond.wait(guard, [&] { return stop || hasPending; });
+		if (!hasPending) return;
+		colouring.swap(pending);
+		hasPending = false;
+		guard.unlock();
+
+		//Write a new file and rename it, so that the file always holds a whole colouring
+		string tmpName = fileName + ".tmp";
+		int n = (int)colouring.size();
+		DimacsWriter out;
+		if (out.open(tmpName.c_str())) {
+			out.putInt(n);
+			out.put('\n');
+			for (int i = 0; i < n; i++) out.colour(i + 1, colouring[i]);
+		}
+		out.close();
+		if (out.fail()) cout << "WARNING: could not write solution file " << tmpName << endl;
+		else {
+#ifdef _WIN32
+			remove(fileName.c_str());
+#endif
+			rename(tmpName.c_str(), fileName.c_str());
+		}
+
+		guard.lock();
+	}
+}
@@ -0,0 +1,46 @@
+#ifndef SOLUTIONWRITER_INCLUDED
+#define SOLUTIONWRITER_INCLUDED
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// Keeps the solution file (one "vertex colour" line per vertex after the number of vertices) up to
+// date with the best colouring found by any run of the process. submit() only copies the colouring
+// when it uses fewer colours than the last one submitted; a writer thread formats it into one buffer
+// and puts it on disk (written to <file>.tmp, then renamed), so the search never waits for the disk
+// and the file is never seen half written. A colouring still waiting to be written is replaced by a
+// better one.
+class SolutionWriter {
+public:
+
+	SolutionWriter(const std::string &fileName);
+	// Waits for the last colouring to be written
+	~SolutionWriter();
+
+	// colouring[i] is the colour of vertex i, from 0
+	void submit(const int *colouring, int n);
+
+	int bestK() { return best; }
+	// Copies the best colouring submitted so far into colouring and returns its number of colours
+	// (INT_MAX, and colouring left empty, if none)
+	int bestColouring(std::vector<int> &colouring);
+
+private:
+
+	void writerLoop();
+
+	std::string fileName;
+	int best;
+	std::vector<int> current;
+
+	std::thread writer;
+	std::mutex lock;
+	std::condition_variable cond;
+	std::vector<int> pending;
+	bool hasPending, stop;
+};
+
+#endif
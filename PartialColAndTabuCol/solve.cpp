@@ -0,0 +1,43 @@
+#include "solve.h"
+#include "initializeColoring.h"
+#include "checkCounter.h"
+#include "rng.h"
+#include <vector>
+#include <algorithm>
+#include <time.h>
+
+using namespace std;
+
+RunResult solveRun(Graph &g, int **neighbors, int constructiveAlg, int seed, KSearchParams &p, int *bestColouring,
+	ostream &confStream, ostream &timeStream, int fixedK)
+{
+	RunResult r;
+	bool miss = false;
+	int fail = 0;
+	vector<int> coloring(g.n);
+
+	//As in main(): the seed of the run is drawn from the generator as it was left
+	numConfChecks = 0;
+	seedRandom(seed + randomInt() % 100);
+
+	clock_t clockStart = clock();
+	p.wallStart = readClock(CLOCK_WALL);
+	r.startK = generateInitialK(g, constructiveAlg, bestColouring, neighbors);
+	int duration = int(((double)(clock() - clockStart) / CLOCKS_PER_SEC) * 1000);
+	confStream << r.startK << "\t" << numConfChecks << "\n";
+	timeStream << r.startK << "\t" << duration << "\t" << int((readClock(CLOCK_WALL) - p.wallStart) * 1000) << "\n";
+
+	//kSearch() attempts the values below the k it is given
+	int k = r.startK;
+	if (fixedK > 0 && k > fixedK + 1) k = fixedK + 1;
+	r.searchK = kSearch(g, neighbors, &coloring[0], bestColouring, k, p, clockStart, confStream, timeStream, miss, fail);
+
+	//The k returned by kSearch() is the one of the results log; count the colours actually used
+	r.bestK = 0;
+	for (int i = 0; i < g.n; i++) if (bestColouring[i] + 1 > r.bestK) r.bestK = bestColouring[i] + 1;
+	r.reached = r.bestK <= max(p.targetCols, p.lowerBound);
+	r.fails = fail;
+	r.checks = numConfChecks;
+	r.seconds = readClock(CLOCK_WALL) - p.wallStart;
+	return r;
+}
@@ -0,0 +1,30 @@
+#ifndef SOLVE_INCLUDED
+#define SOLVE_INCLUDED
+
+#include "Graph.h"
+#include "kSearch.h"
+#include <ostream>
+
+// The outcome of one run: the constructive colouring followed by kSearch()
+struct RunResult {
+	int startK;                  // colours used by the constructive algorithm
+	int bestK;                   // colours used by the best colouring found
+	int searchK;                 // k returned by kSearch(), the one reported in the results log
+	int fails;                   // values of k that kSearch() failed to colour (0 or 1)
+	bool reached;                // bestK <= max(p.targetCols, p.lowerBound)
+	unsigned long long checks;   // constraint checks used by the run
+	double seconds;              // wall-clock time of the run
+};
+
+// Makes one run on g with the given seed, as one iteration of the loop over seeds in main() (without
+// checkpoints): the generator is reseeded from rngState, so with rngState = 1 beforehand this is the
+// first run of "PartialColAndTabuCol -r seed", and calling it again gives the second run, and so on.
+// numConfChecks and rngState are those of the calling thread, so runs can be made on several
+// threads at once as long as p.solution is NULL and the streams are not shared.
+// bestColouring (g.n entries) receives the best colouring found, with colours from 0.
+// With fixedK > 0 the values of k above fixedK are skipped: if the constructive colouring uses more
+// colours, the search goes straight to k = fixedK (p.targetCols should then be fixedK).
+RunResult solveRun(Graph &g, int **neighbors, int constructiveAlg, int seed, KSearchParams &p, int *bestColouring,
+	std::ostream &confStream, std::ostream &timeStream, int fixedK = 0);
+
+#endif
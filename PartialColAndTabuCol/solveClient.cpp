@@ -0,0 +1,212 @@
+/******************************************************************************/
+//  Sends a graph to a solver started with PartialColAndTabuCol --daemon <socket> and writes the
+//  colouring it returns to solution.txt. The options are those of PartialColAndTabuCol, so a run
+//  can be moved to the daemon by replacing the name of the program. See daemon.h for the protocol.
+/******************************************************************************/
+
+#include "../common/dimacsWriter.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <string.h>
+#include <stdlib.h>
+
+#ifndef _WIN32
+#include <limits.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+using namespace std;
+
+void usage() {
+	cout<<"Client of the PartialCol and TabuCol daemon\n\n"
+		<<"USAGE:\n"
+		<<"<InputFile>     (Required unless --graph-hash, --stats or --shutdown is given. File must be in DIMACS format)\n"
+		<<"-t              (If present, TabuCol is used. Else PartialCol is used.)\n"
+		<<"-tt             (If present, a dynamic tabu tenure is used. Otherwise a reactive tenure is used).\n"
+		<<"-s <int>        (Stopping criteria expressed as number of constraint checks. DEFAULT = 100,000,000.)\n"
+		<<"--time-limit <sec>   (Stopping criteria expressed as seconds. DEFAULT = no limit.)\n"
+		<<"--k-time-limit <sec> (Seconds allowed for each value of k. DEFAULT = no limit.)\n"
+		<<"-r <int>        (Random seed. DEFAULT = 1)\n"
+		<<"-T <int>        (Target number of colours. Algorithm halts if this is reached. DEFAULT = 1.)\n"
+		<<"-k <int>        (Only attempt a colouring with <int> colours, instead of descending from the constructive bound.)\n"
+		<<"-v              (Verbosity. If present, the progress of the search is sent to screen.)\n"
+		<<"-a <int>        (Choice of construction algorithm to determine initial value for k. DSsatur = 1, Greedy = 2, RLF = 3. DEFAULT = 1.)\n"
+		<<"--k-search <int> (Strategy for the values of k attempted. Linear descent = 1, Bisection = 2, Galloping = 3. DEFAULT = 1.)\n"
+		<<"--lower-bound <int> (A known lower bound on the number of colours. DEFAULT = 1.)\n"
+		<<"--clique <int>  (Raise the lower bound to the size of a clique, found once per graph by the daemon. None = 0, Greedy = 1, Exact for small graphs = 2. DEFAULT = 1.)\n"
+		<<"--reduce        (If present, the vertices of degree < k and the dominated vertices are taken out before each k and coloured after the search.)\n"
+		<<"--components    (If present, the connected components of the graph are searched separately.)\n"
+		<<"--precolour <file> (Colours that some vertices must get, one \"vertex colour\" line each, e.g. precolorSolution.txt of PrextToGCP. Negative colours are ignored.)\n"
+		<<"--graph-hash <hash> (Solve the graph with this hash, already loaded by the daemon, instead of <InputFile>.)\n"
+		<<"--socket <path> (Socket of the daemon. DEFAULT = partialcol.sock.)\n"
+		<<"--stats         (Print the graphs kept by the daemon and the number of requests solved.)\n"
+		<<"--shutdown      (Stop the daemon.)\n"
+		<<"****\n";
+	exit(1);
+}
+
+#ifdef _WIN32
+
+int main(int argc, char ** argv)
+{
+	cout << "ERROR: the daemon needs Unix-domain sockets, which this build does not support" << endl;
+	return 1;
+}
+
+#else
+
+static bool readPrecolouring(const char *file, string &text)
+{
+	//"vertex colour" lines; a line with one number (the header of precolorSolution.txt) is skipped
+	ifstream in(file);
+	if (in.fail()) return false;
+	string line;
+	while (getline(in, line)) {
+		int v, c;
+		if (sscanf(line.c_str(), "%d %d", &v, &c) != 2 || c < 0) continue;
+		if (!text.empty()) text += ',';
+		text += to_string(v) + "=" + to_string(c);
+	}
+	return true;
+}
+
+int main(int argc, char ** argv)
+{
+	if (argc <= 1) {
+		usage();
+	}
+
+	string request, graphFile, socketPath = "partialcol.sock";
+	int verbose = 0;
+	bool stats = false, shutdownDaemon = false, byHash = false;
+
+	//Read in program parameters; the options of the search are passed on as they are
+	for (int i = 1; i < argc; i++) {
+		if (strcmp("-t", argv[i]) == 0 || strcmp("-tt", argv[i]) == 0 || strcmp("--reduce", argv[i]) == 0 || strcmp("--components", argv[i]) == 0) {
+			request += string(" ") + argv[i];
+		}
+		else if (strcmp("-v", argv[i]) == 0) {
+			verbose++;
+		}
+		else if (strcmp("--stats", argv[i]) == 0) {
+			stats = true;
+		}
+		else if (strcmp("--shutdown", argv[i]) == 0) {
+			shutdownDaemon = true;
+		}
+		else if (argv[i][0] == '-' && i + 1 == argc) {
+			cout << "ERROR: missing value for " << argv[i] << endl;
+			exit(1);
+		}
+		else if (strcmp("--socket", argv[i]) == 0) {
+			socketPath = argv[++i];
+		}
+		else if (strcmp("--precolour", argv[i]) == 0) {
+			string text;
+			if (!readPrecolouring(argv[++i], text)) { cout << "ERROR OPENING precolouring FILE " << argv[i] << endl; exit(1); }
+			if (!text.empty()) request += " --precolour " + text;
+		}
+		else if (strcmp("--graph-hash", argv[i]) == 0) {
+			request += string(" --graph-hash ") + argv[++i];
+			byHash = true;
+		}
+		else if (strcmp("-s", argv[i]) == 0 || strcmp("-r", argv[i]) == 0 || strcmp("-T", argv[i]) == 0 || strcmp("-k", argv[i]) == 0
+			|| strcmp("-a", argv[i]) == 0 || strcmp("--k-search", argv[i]) == 0 || strcmp("--lower-bound", argv[i]) == 0
+			|| strcmp("--clique", argv[i]) == 0 || strcmp("--time-limit", argv[i]) == 0 || strcmp("--k-time-limit", argv[i]) == 0) {
+			request += string(" ") + argv[i] + " " + argv[i + 1];
+			i++;
+		}
+		else if (argv[i][0] == '-') {
+			cout << "ERROR: option " << argv[i] << " cannot be used with the daemon" << endl;
+			usage();
+		}
+		else {
+			//The daemon has its own working directory
+			char path[PATH_MAX];
+			if (realpath(argv[i], path) == NULL) { cout << "ERROR OPENING graph FILE " << argv[i] << endl; exit(1); }
+			graphFile = path;
+		}
+	}
+	if (shutdownDaemon) request = "SHUTDOWN";
+	else if (stats) request = "STATS";
+	else if (!graphFile.empty() && !byHash) request = "SOLVE" + request + " " + graphFile;
+	else if (byHash) request = "SOLVE" + request;
+	else usage();
+
+	sockaddr_un addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0 || connect(fd, (sockaddr *)&addr, sizeof(addr)) != 0) {
+		cout << "ERROR: cannot connect to the daemon on " << socketPath << endl;
+		exit(1);
+	}
+	request += "\n";
+	for (size_t done = 0; done < request.size(); ) {
+		ssize_t r = write(fd, request.data() + done, request.size() - done);
+		if (r <= 0) { cout << "ERROR: the daemon closed the connection" << endl; exit(1); }
+		done += r;
+	}
+
+	//Read the answer line by line until END
+	string buffer, line;
+	char chunk[65536];
+	bool ok = true, ended = false;
+	if (verbose >= 1 && request[0] == 'S' && request[1] == 'O') cout << " COLS   WALL-TIME\tCHECKS" << endl;
+	while (!ended) {
+		size_t eol = buffer.find('\n');
+		if (eol == string::npos) {
+			ssize_t r = read(fd, chunk, sizeof(chunk));
+			if (r <= 0) break;
+			buffer.append(chunk, r);
+			continue;
+		}
+		line = buffer.substr(0, eol);
+		buffer.erase(0, eol + 1);
+
+		if (line == "END") ended = true;
+		else if (line.compare(0, 6, "ERROR ") == 0) {
+			cout << "ERROR: " << line.substr(6) << endl;
+			ok = false;
+		}
+		else if (line.compare(0, 9, "PROGRESS ") == 0) {
+			if (verbose < 1) continue;
+			int k;
+			unsigned long long checks;
+			double seconds;
+			if (sscanf(line.c_str(), "PROGRESS k=%d checks=%llu seconds=%lf", &k, &checks, &seconds) != 3) continue;
+			if (line.find(" failed") != string::npos) cout << "\nNo solution using " << k << " colours was achieved (Checks = " << checks << ", " << int(seconds * 1000) << "ms)" << endl;
+			else cout << setw(5) << k << setw(11) << int(seconds * 1000) << "ms\t" << checks << endl;
+		}
+		else if (line.compare(0, 10, "COLOURING ") == 0 || line == "COLOURING") {
+			//output the solution to a text file, as PartialColAndTabuCol does
+			istringstream in(line.substr(9));
+			vector<int> colouring;
+			int c;
+			while (in >> c) colouring.push_back(c);
+			DimacsWriter solStrm;
+			solStrm.open("solution.txt");
+			solStrm.putInt(colouring.size());
+			solStrm.put('\n');
+			for (size_t i = 0; i < colouring.size(); i++) solStrm.colour(i + 1, colouring[i]);
+			if (!solStrm.close()) cout << "WARNING: could not write solution.txt" << endl;
+		}
+		else if (line.compare(0, 6, "GRAPH ") == 0 && verbose < 1 && !stats) continue;
+		else cout << line << endl;
+	}
+	close(fd);
+	if (!ended) {
+		cout << "ERROR: the daemon closed the connection" << endl;
+		return 1;
+	}
+	return ok ? 0 : 1;
+}
+
+#endif
@@ -1,14 +1,22 @@
 #include "tabu.h"
 #include "initializeColoring.h" 
 #include "manipulateArrays.h"
+#include "parallelScan.h"
+#include "timeLimit.h"
+#include "checkCounter.h"
+#include "kBuckets.h"
+#include "rng.h"
+#include "checkpoint.h"
+#include "trace.h"
 #include <iostream>
 #include <stdlib.h>
 
 using namespace std;
 
-extern unsigned long long numConfChecks;
+THREAD_LOCAL long searchIterations = 0;
 
-long tabu(Graph & g, int * c, int k, unsigned long long maxChecks, int staticTenure, int verbose, int freq, int inc, int ** neighbors) 
+template<class Counter, bool Reactive, bool Verbose, int KMax>
+static long tabuSearch(Graph & g, int * c, int k, unsigned long long maxChecks, int staticTenure, int verbose, int freq, int inc, int ** neighbors, ParallelScan * pool, Checkpointer * ckpt, Tracer * trace, const Deadline & deadline) 
 {
 	int ** nodesByColor; // Arrays of nodes for each color
 	int * nbcPosition;   // Position of each node in the above array
@@ -62,23 +70,26 @@ long tabu(Graph & g, int * c, int k, unsigned long long maxChecks, int staticTen
 		randomTenure = 0;
 	}
 
-	//Make the initial solution
-	initializeColoringForTabu(g, c, k);
+	//Make the initial solution, or take the one of the checkpoint being resumed
+	bool resumed = ckpt != NULL && ckpt->resuming;
+	if (resumed) ckpt->resumeColouring(g, c, 2, k);
+	else initializeColoringForTabu(g, c, k, neighbors);
 
 	//if (verbose>1) cout << "Initialized the coloring\n";
 
-	initializeArrays(nodesByColor, conflicts, tabuStatus, nbcPosition, g, c, k);
+	initializeArrays(nodesByColor, conflicts, tabuStatus, nbcPosition, g, c, k, neighbors);
 
 	// Count the number of conflicts and set up the list nodesInConflict
 	// with the associated list confPosition
 	nodesInConflict[0]=0;
 	for (int i=0; i<g.n; i++) {
-		numConfChecks++;
+		Counter::add(1);
 		if (conflicts[c[i]][i] > 0) {
 			totalConflicts += conflicts[c[i]][i];
 			nodesInConflict[ (confPosition[i]=++nodesInConflict[0]) ] = i;
 		}   
 	}
+	Counter::estimate(g.n);
 	totalConflicts /=2;
 
 	//if (verbose>1) cout << "Initialized the arrays. #Conflicts = " << totalConflicts << endl;
@@ -87,14 +98,46 @@ long tabu(Graph & g, int * c, int k, unsigned long long maxChecks, int staticTen
 
 	// Just in case we already have an admissible k-coloring
 	if (bestSolutionValue == 0) {
+		freeArrays(nodesByColor, conflicts, tabuStatus, nbcPosition, k, g.n);
+		delete [] nodesInConflict;
+		delete [] confPosition;
+		searchIterations = 0;
 		return 0;
 	}
 
 	int minSolutionValue = g.n;
 	int maxSolutionValue = 0;
 
+	SearchState state;
+	if (resumed) {
+		ckpt->resumeSearch(state, g, nodesByColor, nbcPosition, nodesInConflict, confPosition, tabuStatus);
+		totalIterations = state.totalIterations;
+		currentIterations = state.currentIterations;
+		totalConflicts = state.totalConflicts;
+		bestSolutionValue = state.bestSolutionValue;
+		minSolutionValue = state.minSolutionValue;
+		maxSolutionValue = state.maxSolutionValue;
+		tabuTenure = state.tabuTenure;
+		randomTenure = state.randomTenure;
+		pairCycles = state.pairCycles;
+		frequency = state.frequency;
+		increment = state.increment;
+		nextPair = state.nextPair;
+		nextVerbose = state.nextVerbose;
+	}
+
 	while (numConfChecks < maxChecks) {
 
+		// Poll the clock every TIME_POLL iterations, and write a checkpoint when one is due
+		if (totalIterations % TIME_POLL == 0) {
+			if (deadlinePassed(deadline)) break;
+			if (ckpt != NULL && ckpt->due()) {
+				SearchState now = { 2, k, totalIterations, currentIterations, totalConflicts, bestSolutionValue, minSolutionValue, maxSolutionValue,
+					tabuTenure, randomTenure, pairCycles, frequency, increment, nextPair, nextVerbose };
+				ckpt->saveSearch(now, g, c, nodesByColor, nodesInConflict, tabuStatus);
+			}
+		}
+
 		currentIterations++;
 		totalIterations++;
 
@@ -104,28 +147,39 @@ long tabu(Graph & g, int * c, int k, unsigned long long maxChecks, int staticTen
 		int numBest=0;
 
 
-		// Try for every node in conflict
-		for (int iNode=1; iNode <= nodesInConflict[0]; iNode++) {
-			int node = nodesInConflict[iNode];
-			// to move it to every color except its existing one
-			for (int color=1; color<=k; color++) {
-				if (color != c[node]) {
-					numConfChecks+=2;
-					int newValue = totalConflicts + conflicts[color][node] - conflicts[c[node]][node];
-					if (newValue <= bestValue && color != c[node]) {
-						if (newValue < bestValue) {
-							numBest=0;
-						}
-						// Only consider the move if it is not tabu or leads to a new very best solution seen globally.
-						if (tabuStatus[node][color] < totalIterations || (newValue < bestSolutionValue)) {	  
-							// Select the nth move with probability 1/n
-							if (rand()%(numBest+1)==0) {
-								//we will move node "bestNode" to the new colour "bestColour"
-								bestNode = node;
-								bestColor = color;
-								bestValue = newValue;
+		Counter::estimate(2ULL * nodesInConflict[0] * (k - 1));
+		if (pool != NULL && pool->engage(nodesInConflict[0], k)) {
+			// Large neighbourhood: let the worker pool scan slices of nodesInConflict
+			Counter::add(pool->scanTabu(nodesInConflict, c, conflicts, tabuStatus, k, totalIterations, totalConflicts, bestSolutionValue, bestNode, bestColor, bestValue));
+		}
+		else {
+			// Try for every node in conflict
+			for (int iNode=1; iNode <= nodesInConflict[0]; iNode++) {
+				int node = nodesInConflict[iNode];
+				int nodeColor = c[node];
+				int base = totalConflicts - conflicts[nodeColor][node];
+				// to move it to every color except its existing one
+				UNROLL_COLOURS
+				for (int color=1; color<=(KMax ? KMax : k); color++) {
+					if (KMax && color > k) break;
+					if (color != nodeColor) {
+						Counter::add(2);
+						int newValue = base + conflicts[color][node];
+						if (newValue <= bestValue) {
+							if (newValue < bestValue) {
+								numBest=0;
+							}
+							// Only consider the move if it is not tabu or leads to a new very best solution seen globally.
+							if (tabuStatus[node][color] < totalIterations || (newValue < bestSolutionValue)) {	  
+								// Select the nth move with probability 1/n
+								if (randomInt()%(numBest+1)==0) {
+									//we will move node "bestNode" to the new colour "bestColour"
+									bestNode = node;
+									bestColor = color;
+									bestValue = newValue;
+								}
+								numBest++;  // Count the number of considered moves
 							}
-							numBest++;  // Count the number of considered moves
 						}
 					}
 				}
@@ -134,26 +188,29 @@ long tabu(Graph & g, int * c, int k, unsigned long long maxChecks, int staticTen
 
 		// If no non tabu moves have been found, take any random move
 		if (bestNode == -1) {
-			bestNode = rand()%g.n;
-			while ((bestColor = (rand()%k)+1) != c[bestNode]);{
-				numConfChecks+=2;
+			bestNode = randomInt()%g.n;
+			while ((bestColor = (randomInt()%k)+1) != c[bestNode]);{
+				Counter::add(2);
 				bestValue = totalConflicts + conflicts[bestColor][bestNode] - conflicts[c[bestNode]][bestNode];
 			}
 		}
 
 		// Now execute the move
-		if(verbose>=2 && totalIterations % 1000 == 0)
+		if(Verbose && totalIterations % 1000 == 0)
 			cout<<"          -> Iteration "<<totalIterations<<" Cost = "<<totalConflicts<<endl;
 
 		int tTenure = tabuTenure;
-		if (randomTenure == 1) tTenure = (rand()%tTenure)+1;
-		moveNodeToColorForTabu(bestNode, bestColor, g, c, nodesByColor, conflicts, nbcPosition, neighbors, nodesInConflict, confPosition, tabuStatus, totalIterations, tTenure);
+		if (Reactive && randomTenure == 1) tTenure = (randomInt()%tTenure)+1;
+		moveNodeToColorForTabu<Counter>(bestNode, bestColor, g, c, nodesByColor, conflicts, nbcPosition, neighbors, nodesInConflict, confPosition, tabuStatus, totalIterations, tTenure);
 		totalConflicts = bestValue;
 
+		if (trace != NULL && trace->sample(totalIterations))
+			trace->record(totalIterations, k, totalConflicts, totalConflicts < bestSolutionValue ? totalConflicts : bestSolutionValue, tTenure, nc, bestNode, bestColor);
+
 		int max_min = 0;
 
 		//Now update the tabu tenure
-		if (staticTenure == 0) {
+		if (Reactive) {
 			// Update the min and max objective function value
 			if (totalConflicts > maxSolutionValue) maxSolutionValue = totalConflicts;
 			if (totalConflicts < minSolutionValue) minSolutionValue = totalConflicts;
@@ -165,13 +222,13 @@ long tabu(Graph & g, int * c, int k, unsigned long long maxChecks, int staticTen
 					if (pairCycles == nextPair) {
 						if (!freq) {
 							// frequency and increment are not set manually
-							int p = rand()%numPairs;
+							int p = randomInt()%numPairs;
 							frequency = pairs[p][0];
 							increment = pairs[p][1];
 							pairCycles = 0;
 							nextPair = pairs[p][2];
 						}
-						randomTenure = rand()%2;
+						randomTenure = randomInt()%2;
 					}
 				} 
 				else if (tabuTenure) {
@@ -183,7 +240,7 @@ long tabu(Graph & g, int * c, int k, unsigned long long maxChecks, int staticTen
 
 				if (pairCycles == nextPair) {
 					if (!freq) { // frequency and increment are not set manually
-						int p = rand()%numPairs;
+						int p = randomInt()%numPairs;
 						frequency = pairs[p][0];
 						increment = pairs[p][1];
 						pairCycles = 0;
@@ -195,7 +252,7 @@ long tabu(Graph & g, int * c, int k, unsigned long long maxChecks, int staticTen
 			}
 		} 
 		else {
-			tabuTenure = (int)(0.6*nc) + rand()%10;
+			tabuTenure = (int)(0.6*nc) + randomInt()%10;
 		}
 
 		// check: have we a new globally best solution?
@@ -220,7 +277,8 @@ long tabu(Graph & g, int * c, int k, unsigned long long maxChecks, int staticTen
 
 	}// END OF TABU LOOP
 
-	if(verbose>=2) cout<<"          -> Iteration "<<totalIterations<<" Cost = "<<totalConflicts<<endl;
+	if(Verbose) cout<<"          -> Iteration "<<totalIterations<<" Cost = "<<totalConflicts<<endl;
+	searchIterations = totalIterations;
 
 	freeArrays(nodesByColor, conflicts, tabuStatus, nbcPosition, k, g.n);
 	delete [] nodesInConflict;
@@ -229,3 +287,22 @@ long tabu(Graph & g, int * c, int k, unsigned long long maxChecks, int staticTen
 	return totalConflicts;
 
 }
+
+template<class Counter, bool Reactive, bool Verbose>
+static long tabuForK(Graph & g, int * c, int k, unsigned long long maxChecks, int staticTenure, int verbose, int freq, int inc, int ** neighbors, ParallelScan * pool, Checkpointer * ckpt, Tracer * trace, const Deadline & deadline)
+{
+	if (k <= K_SMALL) return tabuSearch<Counter, Reactive, Verbose, K_SMALL>(g, c, k, maxChecks, staticTenure, verbose, freq, inc, neighbors, pool, ckpt, trace, deadline);
+	if (k <= K_MEDIUM) return tabuSearch<Counter, Reactive, Verbose, K_MEDIUM>(g, c, k, maxChecks, staticTenure, verbose, freq, inc, neighbors, pool, ckpt, trace, deadline);
+	return tabuSearch<Counter, Reactive, Verbose, K_GENERIC>(g, c, k, maxChecks, staticTenure, verbose, freq, inc, neighbors, pool, ckpt, trace, deadline);
+}
+
+long tabu(Graph & g, int * c, int k, unsigned long long maxChecks, int staticTenure, int verbose, int freq, int inc, int ** neighbors, ParallelScan * pool, Checkpointer * ckpt, Tracer * trace, const Deadline & deadline)
+{
+	// Pick the kernel for the tenure scheme, verbosity and size of k once, outside the search loop
+	if (staticTenure == 0) {
+		if (verbose >= 2) return tabuForK<CheckCounter, true, true>(g, c, k, maxChecks, staticTenure, verbose, freq, inc, neighbors, pool, ckpt, trace, deadline);
+		return tabuForK<CheckCounter, true, false>(g, c, k, maxChecks, staticTenure, verbose, freq, inc, neighbors, pool, ckpt, trace, deadline);
+	}
+	if (verbose >= 2) return tabuForK<CheckCounter, false, true>(g, c, k, maxChecks, staticTenure, verbose, freq, inc, neighbors, pool, ckpt, trace, deadline);
+	return tabuForK<CheckCounter, false, false>(g, c, k, maxChecks, staticTenure, verbose, freq, inc, neighbors, pool, ckpt, trace, deadline);
+}
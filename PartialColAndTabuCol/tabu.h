@@ -2,8 +2,16 @@
 #define TABU_INCLUDED
 
 #include "Graph.h"
+#include "timeLimit.h"
+#include "threadLocal.h"
 
-long tabu(Graph & g, int * c, int k, unsigned long long maxIterations, int tenure, int verbose, int frequency, int increment, int ** neighbors);
+class ParallelScan;
+class Checkpointer;
+class Tracer;
 
+long tabu(Graph & g, int * c, int k, unsigned long long maxIterations, int tenure, int verbose, int frequency, int increment, int ** neighbors, ParallelScan * pool, Checkpointer * ckpt, Tracer * trace, const Deadline & deadline);
+
+// Iterations made by the last call of tabu() or reactcol() on this thread
+extern THREAD_LOCAL long searchIterations;
 
 #endif
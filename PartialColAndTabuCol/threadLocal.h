@@ -0,0 +1,13 @@
+#ifndef THREADLOCAL_INCLUDED
+#define THREADLOCAL_INCLUDED
+
+// numConfChecks and rngState belong to the thread that runs the search, so that several searches
+// can run side by side in one process (see runExperiments.cpp). With g++, __thread is used because an
+// extern thread_local variable is read through a wrapper function call at every access.
+#if defined(__GNUC__)
+#define THREAD_LOCAL __thread
+#else
+#define THREAD_LOCAL thread_local
+#endif
+
+#endif
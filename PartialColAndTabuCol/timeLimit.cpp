@@ -0,0 +1,24 @@
+#include "timeLimit.h"
+#include <chrono>
+#include <time.h>
+
+using namespace std;
+
+double readClock(int clockType)
+{
+	if (clockType == CLOCK_CPU) return (double)clock() / CLOCKS_PER_SEC;
+	return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool deadlinePassed(const Deadline &d)
+{
+	return d.at > 0 && readClock(d.clockType) >= d.at;
+}
+
+Deadline noDeadline()
+{
+	Deadline d;
+	d.clockType = CLOCK_WALL;
+	d.at = 0;
+	return d;
+}
@@ -0,0 +1,20 @@
+#ifndef TIMELIMIT_INCLUDED
+#define TIMELIMIT_INCLUDED
+
+// Clocks that time limits can be expressed in
+#define CLOCK_WALL 0  // monotonic wall-clock time
+#define CLOCK_CPU 1   // CPU time used by the process
+
+// The search loops only read the clock once every TIME_POLL iterations
+#define TIME_POLL 64
+
+struct Deadline {
+	int clockType;  // CLOCK_WALL or CLOCK_CPU
+	double at;      // time on that clock (in seconds) at which to stop; 0 = no deadline
+};
+
+double readClock(int clockType);
+bool deadlinePassed(const Deadline &d);
+Deadline noDeadline();
+
+#endif
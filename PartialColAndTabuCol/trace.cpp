@@ -0,0 +1,60 @@
+#include "trace.h"
+#include <chrono>
+
+using namespace std;
+
+Tracer::Tracer(const string &fileName, unsigned long long sampleEvery)
+{
+	every = sampleEvery < 1 ? 1 : sampleEvery;
+	run = 0;
+	written = dropped = 0;
+	buffer = new TraceRecord[TRACE_BUFFER];
+	head.store(0);
+	tail.store(0);
+	stop.store(false);
+
+	//The counts in the header are filled in when the trace is closed
+	out.open(fileName.c_str(), ios::binary | ios::trunc);
+	unsigned int version = TRACE_VERSION, recordSize = sizeof(TraceRecord);
+	out.write(TRACE_MAGIC, 8);
+	out.write((const char *)&version, sizeof(version));
+	out.write((const char *)&recordSize, sizeof(recordSize));
+	out.write((const char *)&written, sizeof(written));
+	out.write((const char *)&dropped, sizeof(dropped));
+
+	writer = thread(&Tracer::writerLoop, this);
+}
+
+Tracer::~Tracer()
+{
+	stop.store(true, memory_order_release);
+	writer.join();
+	out.seekp(16);
+	out.write((const char *)&written, sizeof(written));
+	out.write((const char *)&dropped, sizeof(dropped));
+	out.close();
+	delete[] buffer;
+}
+
+void Tracer::writerLoop()
+{
+	while (true) {
+		bool stopping = stop.load(memory_order_acquire);
+		size_t t = tail.load(memory_order_relaxed);
+		size_t h = head.load(memory_order_acquire);
+		if (h == t) {
+			//Everything recorded before stop was set has been written
+			if (stopping) return;
+			this_thread::sleep_for(chrono::milliseconds(2));
+			continue;
+		}
+		//Write the records between tail and head, which may wrap around the end of the buffer
+		size_t start = t & (TRACE_BUFFER - 1);
+		size_t count = h - t;
+		size_t first = count < TRACE_BUFFER - start ? count : TRACE_BUFFER - start;
+		out.write((const char *)(buffer + start), first * sizeof(TraceRecord));
+		if (count > first) out.write((const char *)buffer, (count - first) * sizeof(TraceRecord));
+		written += count;
+		tail.store(h, memory_order_release);
+	}
+}
@@ -0,0 +1,79 @@
+#ifndef TRACE_INCLUDED
+#define TRACE_INCLUDED
+
+#include <atomic>
+#include <fstream>
+#include <string>
+#include <thread>
+
+// One traced iteration of tabu() or reactcol()
+struct TraceRecord {
+	unsigned long long iteration;
+	int run;        // index of the seed in the loop of main()
+	int k;
+	int cost;       // conflicting edges (TabuCol) or uncoloured nodes (PartialCol) after the move
+	int best;       // best cost seen at this k
+	int tenure;     // tabu tenure given to the move
+	int nc;         // nodes in conflict (TabuCol) or uncoloured nodes (PartialCol) before the move
+	int node;       // the move: node and new colour
+	int color;
+};
+
+// Trace file: TRACE_MAGIC, version, sizeof(TraceRecord), number of records, number of dropped records,
+// then the records. traceToCsv converts it to CSV.
+#define TRACE_MAGIC "PCTTRACE"
+#define TRACE_VERSION 1
+
+// Records the search trajectory for tuning the tenure schemes. The search thread puts records into a
+// single-producer ring buffer without locking, and a background thread appends them to the trace file.
+// If the writer falls behind, records are dropped (and counted) rather than stalling the search.
+// The search loops only pay for a NULL test when tracing is off.
+class Tracer {
+public:
+
+	// Records every "every"-th iteration
+	Tracer(const std::string &fileName, unsigned long long every);
+	~Tracer();
+
+	bool fail() { return out.fail(); }
+
+	inline bool sample(unsigned long long iteration) { return iteration % every == 0; }
+
+	inline void record(unsigned long long iteration, int k, int cost, int best, int tenure, int nc, int node, int color)
+	{
+		size_t h = head.load(std::memory_order_relaxed);
+		if (h - tail.load(std::memory_order_acquire) == TRACE_BUFFER) {
+			dropped++;
+			return;
+		}
+		TraceRecord &r = buffer[h & (TRACE_BUFFER - 1)];
+		r.iteration = iteration;
+		r.run = run;
+		r.k = k;
+		r.cost = cost;
+		r.best = best;
+		r.tenure = tenure;
+		r.nc = nc;
+		r.node = node;
+		r.color = color;
+		head.store(h + 1, std::memory_order_release);
+	}
+
+	int run;  // set by main() for each seed
+
+private:
+
+	enum { TRACE_BUFFER = 1 << 16 };  // records, a power of two
+
+	void writerLoop();
+
+	std::ofstream out;
+	unsigned long long every;
+	unsigned long long written, dropped;
+	TraceRecord *buffer;
+	std::atomic<size_t> head, tail;
+	std::atomic<bool> stop;
+	std::thread writer;
+};
+
+#endif
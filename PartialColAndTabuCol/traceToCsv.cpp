@@ -0,0 +1,62 @@
+/******************************************************************************/
+//  Converts a trace written by PartialColAndTabuCol --trace <file> to CSV.
+//
+//  USAGE: traceToCsv <TraceFile> [<CsvFile>]   (CSV goes to the screen if no file is given)
+//
+//  Nodes are numbered from 1 as in the DIMACS file. Colours are those used by the search:
+//  1..k, and 0 for uncoloured nodes in PartialCol.
+/******************************************************************************/
+
+#include "trace.h"
+#include <iostream>
+#include <fstream>
+#include <string.h>
+#include <stdlib.h>
+
+using namespace std;
+
+int main(int argc, char ** argv)
+{
+	if (argc < 2) {
+		cout << "USAGE: traceToCsv <TraceFile> [<CsvFile>]\n";
+		exit(1);
+	}
+	ifstream in(argv[1], ios::binary);
+	if (in.fail()) { cerr << "ERROR OPENING trace FILE " << argv[1] << endl; exit(1); }
+
+	char magic[8];
+	unsigned int version, recordSize;
+	unsigned long long numRecords, dropped;
+	in.read(magic, 8);
+	in.read((char *)&version, sizeof(version));
+	in.read((char *)&recordSize, sizeof(recordSize));
+	in.read((char *)&numRecords, sizeof(numRecords));
+	in.read((char *)&dropped, sizeof(dropped));
+	if (in.fail() || memcmp(magic, TRACE_MAGIC, 8) != 0 || version != TRACE_VERSION || recordSize != sizeof(TraceRecord)) {
+		cerr << argv[1] << " is not a trace written by this version" << endl;
+		exit(1);
+	}
+
+	ofstream csvFile;
+	if (argc > 2) {
+		csvFile.open(argv[2]);
+		if (csvFile.fail()) { cerr << "ERROR OPENING output FILE " << argv[2] << endl; exit(1); }
+	}
+	ostream &csv = argc > 2 ? csvFile : cout;
+
+	//Large buffers, as traces have one line per iteration
+	static char inBuf[1 << 20];
+	in.rdbuf()->pubsetbuf(inBuf, sizeof(inBuf));
+	csv << "run,k,iteration,cost,best,tenure,nc,node,color\n";
+	TraceRecord r;
+	unsigned long long count = 0;
+	while (in.read((char *)&r, sizeof(r))) {
+		csv << r.run << ',' << r.k << ',' << r.iteration << ',' << r.cost << ',' << r.best << ',' << r.tenure << ','
+			<< r.nc << ',' << r.node + 1 << ',' << r.color << '\n';
+		count++;
+	}
+	// A trace whose header was never completed (the run was interrupted) still has its records
+	if (numRecords != 0 && count != numRecords) cerr << "WARNING: header says " << numRecords << " records, " << count << " read" << endl;
+	if (dropped > 0) cerr << dropped << " records were dropped because the writer fell behind" << endl;
+	return 0;
+}
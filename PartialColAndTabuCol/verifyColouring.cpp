@@ -0,0 +1,246 @@
+/******************************************************************************/
+//  Checks a colouring written by PartialColAndTabuCol against its graph, and against the
+//  precolouring it had to extend.
+//
+//  USAGE: verifyColouring <GraphFile> <SolutionFile> [--precolour <file>] [--threads <int>]
+//
+//  Every edge of the DIMACS file is checked; the file is split into one piece per thread, each
+//  thread checking the edges of its piece as it parses them. With --precolour (e.g.
+//  precolorSolution.txt of PrextToGCP: "vertex colour" lines, negative colours meaning not
+//  precoloured) the colours of the solution are matched to those of the precolouring, since the
+//  solver numbers its colour classes its own way: each precolour is paired with the solution
+//  colour that most of its vertices got, and the precoloured vertices left out of their class are
+//  listed. Returns 0 if the colouring is proper and extends the precolouring, 1 otherwise.
+/******************************************************************************/
+
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <chrono>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <limits.h>
+
+using namespace std;
+
+// Number of examples printed for each kind of error
+#define SHOW_ERRORS 10
+
+static bool readFile(const char *file, vector<char> &text)
+{
+	FILE *in = fopen(file, "rb");
+	if (in == NULL) return false;
+	fseek(in, 0, SEEK_END);
+	long size = ftell(in);
+	fseek(in, 0, SEEK_SET);
+	text.resize(size + 1);
+	size_t got = size > 0 ? fread(&text[0], 1, size, in) : 0;
+	fclose(in);
+	text.resize(got + 1);
+	text[got] = '\0';
+	return true;
+}
+
+// Reads the next (optionally negative) integer of the line starting at p; false if there is none
+static bool nextInt(const char *&p, long long &v)
+{
+	while (*p == ' ' || *p == '\t') p++;
+	bool negative = *p == '-';
+	if (negative) p++;
+	if (*p < '0' || *p > '9') return false;
+	v = 0;
+	while (*p >= '0' && *p <= '9') v = v * 10 + (*p++ - '0');
+	if (negative) v = -v;
+	return true;
+}
+
+static const char *nextLine(const char *p)
+{
+	while (*p != '\0' && *p != '\n') p++;
+	return *p == '\n' ? p + 1 : p;
+}
+
+// A solution.txt or precolorSolution.txt: the number of vertices, then "vertex colour" lines
+static bool readColouring(const char *file, vector<int> &colour, const char *what)
+{
+	vector<char> text;
+	if (!readFile(file, text)) { cout << "ERROR OPENING " << what << " FILE " << file << endl; return false; }
+	const char *p = &text[0];
+	long long n, v, c;
+	if (!nextInt(p, n) || n < 0) { cout << file << " does not start with the number of vertices" << endl; return false; }
+	colour.assign(n, -1);
+	for (p = nextLine(p); *p != '\0'; p = nextLine(p)) {
+		if (!nextInt(p, v)) continue;
+		if (!nextInt(p, c) || v < 1 || v > n) { cout << file << ": bad line for vertex " << v << endl; return false; }
+		colour[v - 1] = (int)c;
+	}
+	return true;
+}
+
+struct EdgeCheck {
+	long long edges, badVertices;
+	vector< pair<int, int> > conflicts;  // the first SHOW_ERRORS of them
+	long long numConflicts;
+};
+
+// Checks the 'e' lines of text[from, to), which start at the beginning of a line
+static void checkEdges(const char *from, const char *to, const vector<int> &colour, EdgeCheck &r)
+{
+	long long n = colour.size();
+	r.edges = r.badVertices = r.numConflicts = 0;
+	for (const char *p = from; p < to; p = nextLine(p)) {
+		if (*p != 'e') continue;
+		p++;
+		long long u, v;
+		if (!nextInt(p, u) || !nextInt(p, v) || u < 1 || u > n || v < 1 || v > n) {
+			r.badVertices++;
+			continue;
+		}
+		r.edges++;
+		if (u == v || colour[u - 1] != colour[v - 1]) continue;
+		if (r.numConflicts++ < SHOW_ERRORS) r.conflicts.push_back(make_pair((int)u, (int)v));
+	}
+}
+
+int main(int argc, char ** argv)
+{
+	if (argc < 3) {
+		cout << "USAGE: verifyColouring <GraphFile> <SolutionFile> [--precolour <file>] [--threads <int>]\n";
+		exit(1);
+	}
+	const char *precolourFile = NULL;
+	int numThreads = thread::hardware_concurrency();
+	for (int i = 3; i + 1 < argc; i += 2) {
+		if (strcmp("--precolour", argv[i]) == 0) precolourFile = argv[i + 1];
+		else if (strcmp("--threads", argv[i]) == 0) numThreads = atoi(argv[i + 1]);
+		else { cout << "ERROR: unknown option " << argv[i] << endl; exit(1); }
+	}
+	if (numThreads < 1) numThreads = 1;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+	vector<int> colour, precolour;
+	if (!readColouring(argv[2], colour, "solution")) exit(1);
+	if (precolourFile != NULL && !readColouring(precolourFile, precolour, "precolouring")) exit(1);
+	vector<char> text;
+	if (!readFile(argv[1], text)) { cout << "ERROR OPENING graph FILE " << argv[1] << endl; exit(1); }
+
+	//The edges follow the 'p' line
+	const char *p = &text[0], *end = &text[0] + text.size() - 1;
+	long long n = -1, m = 0;
+	while (p < end && *p != 'p') p = nextLine(p);
+	if (p < end) {
+		p = strstr(p, "edge");
+		const char *q = p == NULL ? NULL : p + 4;
+		if (q != NULL && *q == 's') q++;
+		if (q == NULL || !nextInt(q, n) || !nextInt(q, m)) n = -1;
+		p = nextLine(q == NULL ? end : q);
+	}
+	if (n < 0) { cout << argv[1] << " has no \"p edge\" line" << endl; exit(1); }
+	bool ok = true;
+	if (n != (long long)colour.size()) {
+		cout << "The graph has " << n << " vertices but the solution has " << colour.size() << endl;
+		exit(1);
+	}
+	long long uncoloured = 0;
+	for (long long v = 0; v < n; v++) {
+		if (colour[v] >= 0) continue;
+		if (uncoloured++ < SHOW_ERRORS) cout << "Vertex " << v + 1 << " has no colour" << endl;
+		ok = false;
+	}
+
+	//One piece of the edge lines per thread, cut at line ends
+	vector<const char *> cuts(numThreads + 1, end);
+	cuts[0] = p;
+	for (int t = 1; t < numThreads; t++) {
+		const char *c = p + (end - p) * t / numThreads;
+		if (c < cuts[t - 1]) c = cuts[t - 1];
+		if (c > p && c[-1] != '\n') c = nextLine(c);
+		cuts[t] = c;
+	}
+	vector<EdgeCheck> results(numThreads);
+	vector<thread> threads;
+	for (int t = 1; t < numThreads; t++) threads.push_back(thread(checkEdges, cuts[t], cuts[t + 1], cref(colour), ref(results[t])));
+	checkEdges(cuts[0], cuts[1], colour, results[0]);
+	for (size_t t = 0; t < threads.size(); t++) threads[t].join();
+
+	long long edges = 0, badVertices = 0, conflicts = 0;
+	for (int t = 0; t < numThreads; t++) {
+		edges += results[t].edges;
+		badVertices += results[t].badVertices;
+		for (size_t i = 0; i < results[t].conflicts.size() && conflicts < SHOW_ERRORS; i++, conflicts++)
+			cout << "Conflict: vertices " << results[t].conflicts[i].first << " and " << results[t].conflicts[i].second << " both have colour "
+				<< colour[results[t].conflicts[i].first - 1] << endl;
+	}
+	conflicts = 0;
+	for (int t = 0; t < numThreads; t++) conflicts += results[t].numConflicts;
+	if (badVertices > 0) {
+		cout << badVertices << " edge lines have a vertex out of range or missing" << endl;
+		ok = false;
+	}
+	vector<int> used;
+	for (long long v = 0; v < n; v++) if (colour[v] >= 0) used.push_back(colour[v]);
+	sort(used.begin(), used.end());
+	int numColours = (int)(unique(used.begin(), used.end()) - used.begin());
+	if (conflicts > 0) ok = false;
+	cout << edges << " edge lines checked on " << numThreads << " threads: " << conflicts << " conflicts, " << numColours << " colours";
+	if (uncoloured > 0) cout << ", " << uncoloured << " vertices without a colour";
+	cout << endl;
+
+	if (precolourFile != NULL) {
+		//Pair each precolour with the solution colour most of its vertices got, the most common
+		//pairs first, so that each colour is used for one precolour only
+		vector< pair<int, int> > pinned;  // (precolour, colour) of each precoloured vertex
+		long long numPinned = 0;
+		for (long long v = 0; v < (long long)precolour.size() && v < n; v++) {
+			if (precolour[v] < 0) continue;
+			pinned.push_back(make_pair(precolour[v], colour[v]));
+			numPinned++;
+		}
+		sort(pinned.begin(), pinned.end());
+		vector< pair<long long, pair<int, int> > > counts;
+		for (size_t i = 0; i < pinned.size(); ) {
+			size_t j = i;
+			while (j < pinned.size() && pinned[j] == pinned[i]) j++;
+			counts.push_back(make_pair((long long)(j - i), pinned[i]));
+			i = j;
+		}
+		sort(counts.begin(), counts.end(), [](const pair<long long, pair<int, int> > &a, const pair<long long, pair<int, int> > &b) {
+			return a.first > b.first || (a.first == b.first && a.second < b.second);
+		});
+		vector< pair<int, int> > mapping;  // (precolour, colour)
+		vector<int> mappedPre, mappedCol;
+		for (size_t i = 0; i < counts.size(); i++) {
+			int a = counts[i].second.first, c = counts[i].second.second;
+			if (find(mappedPre.begin(), mappedPre.end(), a) != mappedPre.end() || find(mappedCol.begin(), mappedCol.end(), c) != mappedCol.end()) continue;
+			mappedPre.push_back(a);
+			mappedCol.push_back(c);
+			mapping.push_back(make_pair(a, c));
+		}
+		sort(mapping.begin(), mapping.end());
+		cout << numPinned << " precoloured vertices, " << mapping.size() << " precolours. Permutation (precolour -> colour):";
+		for (size_t i = 0; i < mapping.size(); i++) cout << ' ' << mapping[i].first << "->" << mapping[i].second;
+		cout << endl;
+
+		long long wrong = 0;
+		for (long long v = 0; v < (long long)precolour.size() && v < n; v++) {
+			if (precolour[v] < 0) continue;
+			vector< pair<int, int> >::iterator it = lower_bound(mapping.begin(), mapping.end(), make_pair(precolour[v], INT_MIN));
+			int expected = it != mapping.end() && it->first == precolour[v] ? it->second : -1;
+			if (colour[v] == expected) continue;
+			if (wrong++ < SHOW_ERRORS) {
+				cout << "Vertex " << v + 1 << " has precolour " << precolour[v] << " but colour " << colour[v];
+				if (expected >= 0) cout << " instead of " << expected;
+				cout << endl;
+			}
+		}
+		//A graph transformed by PrextToGCP has the vertices of the clique K_k after those of the precolouring
+		if (precolour.size() > (size_t)n) cout << "The precolouring has " << precolour.size() << " vertices, only the first " << n << " are compared" << endl;
+		cout << wrong << " precoloured vertices are not in the class of their precolour" << endl;
+		if (wrong > 0) ok = false;
+	}
+
+	cout << (ok ? "VALID" : "INVALID") << " (" << chrono::duration<double>(chrono::steady_clock::now() - start).count() << "s)" << endl;
+	return ok ? 0 : 1;
+}
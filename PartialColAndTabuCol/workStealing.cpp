@@ -0,0 +1,84 @@
+#include "workStealing.h"
+
+using namespace std;
+
+WorkStealingPool::WorkStealingPool(int n)
+{
+	numWorkers = n < 1 ? 1 : n;
+	current = NULL;
+	generation = 0;
+	busy = 0;
+	stop = false;
+	for (int i = 0; i < numWorkers; i++) queues.push_back(new WorkerQueue);
+	for (int i = 0; i < numWorkers; i++) workers.push_back(thread(&WorkStealingPool::workerLoop, this, i));
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+	{
+		unique_lock<mutex> guard(lock);
+		stop = true;
+	}
+	startCond.notify_all();
+	for (size_t i = 0; i < workers.size(); i++) workers[i].join();
+	for (size_t i = 0; i < queues.size(); i++) delete queues[i];
+}
+
+void WorkStealingPool::run(int numJobs, const function<void(int, int)> &job)
+{
+	//Deal the jobs out in turn, so that every worker starts with a mix of the grid
+	for (int j = 0; j < numJobs; j++) queues[j % numWorkers]->jobs.push_back(j);
+	unique_lock<mutex> guard(lock);
+	current = &job;
+	busy = numWorkers;
+	generation++;
+	startCond.notify_all();
+	doneCond.wait(guard, [&] { return busy == 0; });
+	current = NULL;
+}
+
+bool WorkStealingPool::nextJob(int id, int &job)
+{
+	{
+		WorkerQueue &own = *queues[id];
+		lock_guard<mutex> guard(own.lock);
+		if (!own.jobs.empty()) {
+			job = own.jobs.front();
+			own.jobs.pop_front();
+			return true;
+		}
+	}
+	//Steal from the others, starting with the next worker
+	for (int i = 1; i < numWorkers; i++) {
+		WorkerQueue &victim = *queues[(id + i) % numWorkers];
+		lock_guard<mutex> guard(victim.lock);
+		if (!victim.jobs.empty()) {
+			job = victim.jobs.back();
+			victim.jobs.pop_back();
+			return true;
+		}
+	}
+	return false;
+}
+
+void WorkStealingPool::workerLoop(int id)
+{
+	unsigned long seen = 0;
+	while (true) {
+		const function<void(int, int)> *job;
+		{
+			unique_lock<mutex> guard(lock);
+			startCond.wait(guard, [&] { return stop || generation != seen; });
+			if (stop) return;
+			seen = generation;
+			job = current;
+		}
+		//Jobs are only added before a run starts, so an empty search means that all have been taken
+		int j;
+		while (nextJob(id, j)) (*job)(j, id);
+		{
+			unique_lock<mutex> guard(lock);
+			if (--busy == 0) doneCond.notify_all();
+		}
+	}
+}
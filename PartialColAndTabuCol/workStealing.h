@@ -0,0 +1,49 @@
+#ifndef WORKSTEALING_INCLUDED
+#define WORKSTEALING_INCLUDED
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+
+// A persistent pool of threads for running many independent jobs, such as the runs of an experiment.
+// The jobs are dealt out to one deque per worker; a worker takes jobs from the front of its own deque
+// and, when it is empty, steals from the back of another one. Runs that end early or late therefore
+// balance out without every worker contending on one shared queue.
+class WorkStealingPool {
+public:
+
+	WorkStealingPool(int numWorkers);
+	~WorkStealingPool();
+
+	// Calls job(j, worker) for every j in 0..numJobs-1, worker being the index of the thread
+	// (0..size()-1), and returns once all jobs have finished
+	void run(int numJobs, const std::function<void(int, int)> &job);
+
+	int size() { return numWorkers; }
+
+private:
+
+	struct WorkerQueue {
+		std::mutex lock;
+		std::deque<int> jobs;
+	};
+
+	void workerLoop(int id);
+	bool nextJob(int id, int &job);
+
+	int numWorkers;
+	std::vector<std::thread> workers;
+	std::vector<WorkerQueue *> queues;
+	const std::function<void(int, int)> *current;
+
+	std::mutex lock;
+	std::condition_variable startCond, doneCond;
+	unsigned long generation;
+	int busy;
+	bool stop;
+};
+
+#endif
@@ -20,6 +20,7 @@
 /******************************************************************************/
 #include "stdafx.h"
 #include "PreGCPFixedKTransformation.h"
+#include "../../common/dimacsWriter.h"
 #include <string.h>
 #include <fstream>
 #include <iostream>
@@ -479,12 +480,13 @@ int main(int argc, char ** argv) {
 		precolor(candSol, colNode, numPrecolorsChosen);
 
 		// Output the solution to a text file
-		ofstream solStrm;
+		DimacsWriter solStrm;
 		solStrm.open("precolorSolution.txt");
-		solStrm << numNodes << "\n";
+		solStrm.putInt(numNodes);
+		solStrm.put('\n');
 		// from the first line, for each node, print the color class it was assigned to 
-		for (i = 0;i < numNodes;i++) solStrm << i + 1 << ' ' << colNode[i] << "\n";
-		solStrm.close();
+		for (i = 0;i < numNodes;i++) solStrm.colour(i + 1, colNode[i]);
+		if (!solStrm.close()) cerr << "Error writing precolorSolution.txt\n";
 	}
 
 	//Stop the timer.
@@ -518,29 +520,29 @@ int main(int argc, char ** argv) {
 			resultsLog.close();
 
 
-			//Set up input file, read, and close (input must be in DIMACS format)
-			ifstream in1;
-			in1.open(argv[i]);
+			//Input file, whose edges are copied at the end (input must be in DIMACS format)
+			const char *inputFile = argv[i];
 
-			ofstream newStrm;
+			DimacsWriter newStrm;
 			newStrm.open("newgraph.txt");
 
-			newStrm << "c Adapting Precoloring Extensions problem to Graph Coloring problem\n"
-				<< "c \n"
-				<< "c Initial input graph has [" << numNodes << "] nodes and [" << numEdges << "] edges.\n"
-				<< "c A total of [" << numNodesIndepSet.size() << "] nodes has been precolored with [" << numPrecolorsChosen << "] distinct number of colors.\n"
-				<< "c Your input graph has been precolored and transformed.\n"
-				<< "c It can now be run as an ordinary Graph Coloring Problem.\n"
-				<< "c newgraph.txt is in DIMACS format.\n"
-				<< "c *********************************************************************************\n"
-				<< "a " << numPrecolorsChosen << "\n";
+			newStrm.put("c Adapting Precoloring Extensions problem to Graph Coloring problem\n"
+				"c \n"
+				"c Initial input graph has [" + to_string(numNodes) + "] nodes and [" + to_string(numEdges) + "] edges.\n"
+				"c A total of [" + to_string(numNodesIndepSet.size()) + "] nodes has been precolored with [" + to_string(numPrecolorsChosen) + "] distinct number of colors.\n"
+				"c Your input graph has been precolored and transformed.\n"
+				"c It can now be run as an ordinary Graph Coloring Problem.\n"
+				"c newgraph.txt is in DIMACS format.\n"
+				"c *********************************************************************************\n"
+				"a " + to_string(numPrecolorsChosen) + "\n");
 				for (int i = 0; i < numNodesIndepSet.size(); i++) {
-					newStrm << "d " << numNodesIndepSet[i] +1 << "\n";
+					newStrm.put("d ", 2);
+					newStrm.putInt(numNodesIndepSet[i] +1);
+					newStrm.put('\n');
 				}
 			
 
-			//newStrm << numNodes << '+' << candSol.size() << "\n";
-			newStrm << "p edge " << numNodes + candSol.size() << ' ' << numEdges + ((candSol.size())*(candSol.size() - 1) / 2) << "\n";
+			newStrm.header(numNodes + candSol.size(), numEdges + ((candSol.size())*(candSol.size() - 1) / 2));
 
 			vector<int>::iterator pos1;
 			pos1 = max_element(colNode.begin(), colNode.end());
@@ -553,7 +555,7 @@ int main(int argc, char ** argv) {
 							// i+1 because edges are defined with nodes that start from index 1
 							// numNodes+1 because adding a complete graph to existing graph requires new nodes to start from index numNodes+1
 							//FOR DEBUGGING: newStrm << "e " << i + 1 << ' ' << numNodes + 1 << '+' << j << ' ' << "\n";
-							newStrm << "e " << i + 1 << ' ' << numNodes + 1 + j << "\n";
+							newStrm.edge(i + 1, numNodes + 1 + j);
 						}
 					}
 				}
@@ -563,7 +565,7 @@ int main(int argc, char ** argv) {
 			for (int g = numNodes + 1; g < numNodes + candSol.size() + 1; g++) {
 				for (int f = numNodes + 1; f < numNodes + candSol.size() + 1; f++) {
 					if (f != g) {
-						newStrm << "e " << g << ' ' << f << "\n";
+						newStrm.edge(g, f);
 					}
 				}
 			}
@@ -571,16 +573,8 @@ int main(int argc, char ** argv) {
 			
 
 			// Combine the K_k and new edges to original graph.txt file
-			std::string line;
-			while (std::getline(in1, line))
-			{
-				if (line.find('e') == 0)
-					// copy line to output
-					newStrm << line << '\n';
-				//continue;
-			}
-			in1.close();
-			newStrm.close();
+			if (!newStrm.appendEdgeLines(inputFile)) cerr << "Error reading " << inputFile << "\n";
+			if (!newStrm.close()) cerr << "Error writing newgraph.txt\n";
 
 			// if k is specified, algorithm outputs newnewgraph.txt for the specified k.
 			if (prepareForGCP = 2) {
@@ -589,26 +583,31 @@ int main(int argc, char ** argv) {
 			}
 
 			// Produce a colorsolution.txt file, which shows the indices of vertices in their respective color classes
-			ofstream colStrm;
+			DimacsWriter colStrm;
 			colStrm.open("colorsolution.txt");
-			colStrm << candSol.size() << "\n";
+			colStrm.putInt(candSol.size());
+			colStrm.put('\n');
 
 			int k, count = 0, group;
 			for (group = 0; group < candSol.size(); group++) {
-				colStrm << "C-" << group << "\t= {";
-				if (candSol[group].size() == 0) colStrm << "empty}\n";
+				colStrm.put("C-", 2);
+				colStrm.putInt(group);
+				colStrm.put("\t= {", 4);
+				if (candSol[group].size() == 0) colStrm.put("empty}\n");
 				else {
 					for (k = 0; k < candSol[group].size() - 1; k++) {
-						colStrm << candSol[group][k]+1 << ", ";
+						colStrm.putInt(candSol[group][k]+1);
+						colStrm.put(", ", 2);
 					}
-					colStrm << candSol[group][candSol[group].size() - 1]+1 << "}\n";
+					colStrm.putInt(candSol[group][candSol[group].size() - 1]+1);
+					colStrm.put("}\n", 2);
 					count = count + candSol[group].size();
 				}
 			}
-			colStrm << "Total Number of Nodes and Edges = " << '(' << numNodes << ", " << numEdges << ')' << endl;
-			colStrm << "Number of Nodes in maximal independent set = " << numNodesIndepSet.size() << endl;
-			colStrm << "Precolored vertices have " << candSol.size() << " unique number of color(s)." << endl;
-			colStrm.close();
+			colStrm.put("Total Number of Nodes and Edges = (" + to_string(numNodes) + ", " + to_string(numEdges) + ")\n");
+			colStrm.put("Number of Nodes in maximal independent set = " + to_string(numNodesIndepSet.size()) + "\n");
+			colStrm.put("Precolored vertices have " + to_string(candSol.size()) + " unique number of color(s).\n");
+			if (!colStrm.close()) cerr << "Error writing colorsolution.txt\n";
 
 		}
 	}
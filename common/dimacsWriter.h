@@ -0,0 +1,215 @@
+#ifndef DIMACSWRITER_INCLUDED
+#define DIMACSWRITER_INCLUDED
+
+// Writes DIMACS graphs and "vertex colour" files quickly: numbers are formatted by hand, two
+// digits at a time, into a large buffer, which goes to the file in a single write() call whenever
+// it is full. Shared by GenRandomGraphDensity, PrextToGCP and PartialColAndTabuCol; it only needs
+// the C library, so each of them includes it directly.
+//
+//	DimacsWriter out;
+//	if (!out.open("graph.txt")) ...
+//	out.header(n, m);
+//	out.edge(1, 2);
+//	if (!out.close()) ...	// false if anything could not be written
+
+#include <string>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+class DimacsWriter {
+public:
+
+	DimacsWriter(size_t bufferSize = 1 << 22) : fd(-1), ok(true), buffer(new char[bufferSize]), size(bufferSize), length(0) {}
+	~DimacsWriter() { close(); delete[] buffer; }
+
+	// Creates (or empties) the file
+	bool open(const char *file) {
+		close();
+#ifdef _WIN32
+		fd = _open(file, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+		fd = ::open(file, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+		ok = fd >= 0;
+		return ok;
+	}
+
+	// Writes into an existing file from the given byte on, leaving the rest of it as it is, so
+	// that several writers can fill their own parts of one file
+	bool openAt(const char *file, unsigned long long offset) {
+		close();
+#ifdef _WIN32
+		fd = _open(file, _O_WRONLY | _O_BINARY);
+		ok = fd >= 0 && _lseeki64(fd, (long long)offset, SEEK_SET) >= 0;
+#else
+		fd = ::open(file, O_WRONLY);
+		ok = fd >= 0 && lseek(fd, (off_t)offset, SEEK_SET) >= 0;
+#endif
+		return ok;
+	}
+
+	// Writes what is left in the buffer and closes the file; false if any write failed
+	bool close() {
+		if (fd < 0) return ok;
+		flush();
+#ifdef _WIN32
+		if (_close(fd) != 0) ok = false;
+#else
+		if (::close(fd) != 0) ok = false;
+#endif
+		fd = -1;
+		return ok;
+	}
+
+	bool fail() const { return !ok; }
+
+	void put(char c) {
+		if (length == size) flush();
+		buffer[length++] = c;
+	}
+
+	void put(const char *s, size_t len) {
+		if (length + len > size) flush();
+		if (len > size) {
+			writeAll(s, len);
+			return;
+		}
+		memcpy(buffer + length, s, len);
+		length += len;
+	}
+
+	void put(const char *s) { put(s, strlen(s)); }
+	void put(const std::string &s) { put(s.data(), s.size()); }
+
+	void putInt(long long v) {
+		if (length + 21 > size) flush();
+		unsigned long long u = (unsigned long long)v;
+		if (v < 0) {
+			buffer[length++] = '-';
+			u = 0 - u;
+		}
+		length += formatInt(buffer + length, u);
+	}
+
+	// "p edge n m"
+	void header(long long n, long long m) {
+		put("p edge ", 7);
+		putInt(n);
+		put(' ');
+		putInt(m);
+		put('\n');
+	}
+
+	// "e u v", the vertices numbered from 1
+	void edge(long long u, long long v) {
+		if (length + 44 > size) flush();
+		buffer[length++] = 'e';
+		buffer[length++] = ' ';
+		length += formatInt(buffer + length, (unsigned long long)u);
+		buffer[length++] = ' ';
+		length += formatInt(buffer + length, (unsigned long long)v);
+		buffer[length++] = '\n';
+	}
+
+	// Copies the lines of another DIMACS file that start with 'e', read in large blocks; false if
+	// it cannot be opened
+	bool appendEdgeLines(const char *file) {
+		FILE *in = fopen(file, "rb");
+		if (in == NULL) return false;
+		char *block = new char[1 << 20];
+		bool lineStart = true, copying = false;
+		size_t got;
+		while ((got = fread(block, 1, 1 << 20, in)) > 0) {
+			size_t i = 0;
+			while (i < got) {
+				if (lineStart) copying = block[i] == 'e';
+				const char *end = (const char *)memchr(block + i, '\n', got - i);
+				size_t stop = end == NULL ? got : end - block + 1;
+				if (copying) put(block + i, stop - i);
+				lineStart = end != NULL;
+				i = stop;
+			}
+		}
+		//The last line may have no line end
+		if (copying && !lineStart) put('\n');
+		delete[] block;
+		fclose(in);
+		return true;
+	}
+
+	// "vertex colour", as solution.txt and precolorSolution.txt
+	void colour(long long vertex, long long c) {
+		putInt(vertex);
+		put(' ');
+		putInt(c);
+		put('\n');
+	}
+
+	// Number of characters of v written by putInt() (v >= 0)
+	static int numDigits(unsigned long long v) {
+		int len = 1;
+		while (v >= 100) { v /= 100; len += 2; }
+		return v >= 10 ? len + 1 : len;
+	}
+
+	// Writes the digits of v at p and returns their number
+	static int formatInt(char *p, unsigned long long v) {
+		static const char pairs[] =
+			"00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+			"40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+			"8081828384858687888990919293949596979899";
+		int len = numDigits(v), i = len;
+		while (v >= 100) {
+			unsigned int d = (unsigned int)(v % 100) * 2;
+			v /= 100;
+			p[--i] = pairs[d + 1];
+			p[--i] = pairs[d];
+		}
+		if (v >= 10) {
+			p[--i] = pairs[v * 2 + 1];
+			p[--i] = pairs[v * 2];
+		}
+		else p[--i] = (char)('0' + v);
+		return len;
+	}
+
+private:
+
+	void flush() {
+		writeAll(buffer, length);
+		length = 0;
+	}
+
+	void writeAll(const char *p, size_t len) {
+		while (len > 0 && ok && fd >= 0) {
+			unsigned int chunk = len > (1u << 30) ? 1u << 30 : (unsigned int)len;
+#ifdef _WIN32
+			int done = _write(fd, p, chunk);
+#else
+			ssize_t done = write(fd, p, chunk);
+#endif
+			if (done <= 0) ok = false;
+			else {
+				p += done;
+				len -= done;
+			}
+		}
+	}
+
+	DimacsWriter(const DimacsWriter &);
+	DimacsWriter &operator=(const DimacsWriter &);
+
+	int fd;
+	bool ok;
+	char *buffer;
+	size_t size, length;
+};
+
+#endif